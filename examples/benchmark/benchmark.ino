@@ -0,0 +1,322 @@
+/**********************************************************
+ * @file    benchmark.ino
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Counts the CPU cycles taken by update(), draw() and the
+ * drawing methods, and prints them on the serial port at
+ * 115200 baud, one per line:
+ *
+ *   <name> <cycles>
+ *
+ * followed by "done".  Timer 1 counts every cycle, so the
+ * numbers are exact (less a fixed overhead that's measured
+ * and subtracted), the same on real hardware as under the
+ * simavr simulator.  See extras/benchmark for running it
+ * under simavr and checking the numbers against a
+ * baseline.
+ *
+ * Build it with the same compile-time options as the
+ * sketch you care about; update() in particular is a
+ * different method for each of them.
+**********************************************************/
+#include <Uno_HUB75_Driver.h>
+#if HUB75_DISPLAY_LIST
+#include <Uno_HUB75_DisplayList.h>
+#endif
+#include <avr/sleep.h>
+
+// instantiate the panel object
+Uno_HUB75_Driver panel;
+
+// an 8x8 icon in both sprite formats
+static const uint8_t icon1Bits[] PROGMEM =
+{
+  0x3c, 0x42, 0xa5, 0x81, 0xa5, 0x99, 0x42, 0x3c
+};
+static const Uno_HUB75_Driver::Sprite icon1 PROGMEM =
+{
+  icon1Bits, 8, 8, 1, Uno_HUB75_Driver::SPRITE_1BPP, 8
+};
+
+static const uint8_t icon3Bits[] PROGMEM =
+{
+  0x88, 0x33, 0x33, 0x88,  0x83, 0x33, 0x33, 0x38,
+  0x33, 0x03, 0x30, 0x33,  0x33, 0x33, 0x33, 0x33,
+  0x33, 0x13, 0x31, 0x33,  0x33, 0x31, 0x13, 0x33,
+  0x83, 0x33, 0x33, 0x38,  0x88, 0x33, 0x33, 0x88
+};
+static const Uno_HUB75_Driver::Sprite icon3 PROGMEM =
+{
+  icon3Bits, 8, 8, 1, Uno_HUB75_Driver::SPRITE_3BPP, 8
+};
+
+// a hexagon for polygon()
+static const Uno_HUB75_Driver::Point hexagon[] =
+{
+  {10, 2}, {16, 2}, {20, 7}, {16, 12}, {10, 12}, {6, 7}
+};
+
+// two frames of diagonal color bars, packed by img2anim.py for the
+// default build (one 32x16 panel, 8 colors); every row changes
+#if BUFFCOLS == 32 && PLANES * SCANROWS == 8 && !HUB75_BITPLANE
+static const uint8_t barsData[] PROGMEM =
+{
+  0x0a, 0xff, 0x40, 0x09, 0x64, 0x09, 0x88, 0x09, 0xac, 0x09, 0xd0, 0x09,
+  0xf4, 0x09, 0x18, 0x09, 0x3c, 0x03, 0x40, 0x05, 0x64, 0x09, 0x88, 0x09,
+  0xac, 0x09, 0xd0, 0x09, 0xf4, 0x09, 0x18, 0x09, 0x3c, 0x09, 0x40, 0x40,
+  0x01, 0x64, 0x09, 0x88, 0x09, 0xac, 0x09, 0xd0, 0x09, 0xf4, 0x09, 0x18,
+  0x09, 0x3c, 0x09, 0x40, 0x03, 0x40, 0x64, 0x09, 0x88, 0x09, 0xac, 0x09,
+  0xd0, 0x09, 0xf4, 0x09, 0x18, 0x09, 0x3c, 0x09, 0x40, 0x03, 0x64, 0x09,
+  0x88, 0x09, 0xac, 0x09, 0xd0, 0x09, 0xf4, 0x09, 0x18, 0x09, 0x3c, 0x09,
+  0x40, 0x03, 0x64, 0x05, 0x88, 0x09, 0xac, 0x09, 0xd0, 0x09, 0xf4, 0x09,
+  0x18, 0x09, 0x3c, 0x09, 0x40, 0x09, 0x64, 0x64, 0x01, 0x88, 0x09, 0xac,
+  0x09, 0xd0, 0x09, 0xf4, 0x09, 0x18, 0x09, 0x3c, 0x09, 0x40, 0x09, 0x64,
+  0x03, 0x64, 0x88, 0x09, 0xac, 0x09, 0xd0, 0x09, 0xf4, 0x09, 0x18, 0x09,
+  0x3c, 0x09, 0x40, 0x09, 0x64, 0x03, 0x0a, 0xff, 0x0a, 0x64, 0x0a, 0x88,
+  0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a, 0x18, 0x0a, 0x3c, 0x0a, 0x40,
+  0x06, 0x64, 0x0a, 0x88, 0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a, 0x18,
+  0x0a, 0x3c, 0x0a, 0x40, 0x03, 0x02, 0x64, 0x0a, 0x88, 0x0a, 0xac, 0x0a,
+  0xd0, 0x0a, 0xf4, 0x0a, 0x18, 0x0a, 0x3c, 0x0a, 0x40, 0x03, 0x64, 0x0a,
+  0x88, 0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a, 0x18, 0x0a, 0x3c, 0x0a,
+  0x40, 0x03, 0x0a, 0x88, 0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a, 0x18,
+  0x0a, 0x3c, 0x0a, 0x40, 0x0a, 0x64, 0x06, 0x88, 0x0a, 0xac, 0x0a, 0xd0,
+  0x0a, 0xf4, 0x0a, 0x18, 0x0a, 0x3c, 0x0a, 0x40, 0x0a, 0x64, 0x03, 0x02,
+  0x88, 0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a, 0x18, 0x0a, 0x3c, 0x0a,
+  0x40, 0x0a, 0x64, 0x03, 0x88, 0x0a, 0xac, 0x0a, 0xd0, 0x0a, 0xf4, 0x0a,
+  0x18, 0x0a, 0x3c, 0x0a, 0x40, 0x0a, 0x64, 0x03
+};
+static const uint16_t barsIndex[] PROGMEM =
+{
+  0, 138
+};
+static const Uno_HUB75_Driver::Animation bars PROGMEM =
+{
+  barsData, barsIndex, 2, 32, 8
+};
+#endif
+
+// Timer 1 overflows while counting
+static volatile uint16_t overflows = 0;
+
+// cycles taken by starting and stopping the count
+static uint32_t overhead = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+  ++overflows;
+}
+
+/******************************************
+* startCount()
+*******************************************
+* Start Timer 1 from zero, counting every
+* CPU cycle
+******************************************/
+static inline void startCount()
+{
+  TCCR1B = 0;
+  TCNT1 = 0;
+  overflows = 0;
+  TIFR1 = bit(TOV1);
+  TCCR1B = bit(CS10);
+}
+
+/******************************************
+* stopCount()
+*******************************************
+* Stop Timer 1 and return the cycles since
+* startCount(), less the overhead.  The
+* overflow ISR adds about 30 cycles every
+* 65536, which is left in
+******************************************/
+static inline uint32_t stopCount()
+{
+  TCCR1B = 0;
+
+  uint32_t cycles = TCNT1;
+  cycles += (uint32_t)overflows << 16;
+
+  return (cycles > overhead ? cycles - overhead : 0);
+}
+
+/******************************************
+* report()
+*******************************************
+* Print one result, and wait for it to be
+* sent so the UART interrupt doesn't land
+* in the next measurement
+******************************************/
+static void report(const __FlashStringHelper* name, uint32_t cycles)
+{
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.println(cycles);
+  Serial.flush();
+}
+
+// count the cycles of 'code' and report them as 'name'
+#define BENCH(name, code)   { startCount(); code; report(F(name), stopCount()); }
+
+void setup()
+{
+  Serial.begin(115200);
+
+  // not using the HUB75 timer ISR; update() is called directly
+  panel.begin(false);
+
+  // stop the millis() interrupt from landing in a measurement
+  TIMSK0 = 0;
+
+  // Timer 1, normal mode, overflow interrupt
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TIMSK1 = bit(TOIE1);
+
+  // overhead of an empty measurement
+  startCount();
+  overhead = stopCount();
+
+  Uno_HUB75_Driver::Rect src = {0, 0, 15, 7};
+  Uno_HUB75_Driver::Rect dst = {8, 4, 23, 11};
+
+  // refresh
+  BENCH("update",                 panel.update());
+
+  panel.fillAll(Uno_HUB75_Driver::RED);
+  BENCH("draw_all_rows",          panel.draw());
+#if HUB75_PAGE_FLIP
+  while (panel.flipPending())
+  {
+    panel.update();
+  }
+#endif
+  BENCH("draw_no_rows",           panel.draw());
+
+  panel.setPixel(0, 0, Uno_HUB75_Driver::BLUE);
+  BENCH("draw_one_row",           panel.draw());
+#if HUB75_PAGE_FLIP
+  while (panel.flipPending())
+  {
+    panel.update();
+  }
+#endif
+
+#if HUB75_LAYERS
+  // the same, merged with a background in RAM
+  static uint8_t backdrop[PLANES * SCANROWS * BUFFCOLS];
+  panel.saveBackground(backdrop);
+  panel.setBackground(backdrop);
+  BENCH("draw_layers_all_rows",   panel.draw());
+
+  panel.setPixel(0, 0, Uno_HUB75_Driver::GREEN);
+  BENCH("draw_layers_one_row",    panel.draw());
+  panel.setBackground(NULL);
+#endif
+
+  // whole panel
+  BENCH("fillAll",                panel.fillAll(Uno_HUB75_Driver::GREEN));
+  BENCH("clear",                  panel.clear());
+
+  // pixels
+  BENCH("setPixel",               panel.setPixel(5, 5, Uno_HUB75_Driver::CYAN));
+  BENCH("setPixel_offpanel",      panel.setPixel(-5, 5, Uno_HUB75_Driver::CYAN));
+  BENCH("getPixel",               panel.getPixel(5, 5));
+
+  // lines at several angles
+  BENCH("line_horizontal",        panel.line(0, 5, MAXX, 5, Uno_HUB75_Driver::WHITE));
+  BENCH("line_vertical",          panel.line(5, 0, 5, MAXY, Uno_HUB75_Driver::WHITE));
+  BENCH("line_45",                panel.line(0, 0, MAXY, MAXY, Uno_HUB75_Driver::WHITE));
+  BENCH("line_shallow",           panel.line(0, 0, MAXX, 3, Uno_HUB75_Driver::WHITE));
+  BENCH("line_steep",             panel.line(0, 0, 3, MAXY, Uno_HUB75_Driver::WHITE));
+  BENCH("line_diagonal",          panel.line(0, 0, MAXX, MAXY, Uno_HUB75_Driver::WHITE));
+  BENCH("line_clipped",           panel.line(-100, -40, MAXX + 100, MAXY + 40, Uno_HUB75_Driver::WHITE));
+  BENCH("line_offpanel",          panel.line(-100, -40, -10, MAXY + 40, Uno_HUB75_Driver::WHITE));
+
+  // rectangles
+  BENCH("rectangle_fill_full",    panel.rectangle(0, 0, MAXX, MAXY, Uno_HUB75_Driver::MAGENTA, true));
+  BENCH("rectangle_fill_small",   panel.rectangle(3, 3, 12, 10, Uno_HUB75_Driver::MAGENTA, true));
+  BENCH("rectangle_outline",      panel.rectangle(0, 0, MAXX, MAXY, Uno_HUB75_Driver::MAGENTA, false));
+
+  // circles, ellipses and polygons
+  BENCH("circle_fill",            panel.circle(15, 7, 7, Uno_HUB75_Driver::GREEN, true));
+  BENCH("circle_outline",         panel.circle(15, 7, 7, Uno_HUB75_Driver::GREEN, false));
+  BENCH("ellipse_fill",           panel.ellipse(15, 7, 14, 6, Uno_HUB75_Driver::GREEN, true));
+  BENCH("ellipse_outline",        panel.ellipse(15, 7, 14, 6, Uno_HUB75_Driver::GREEN, false));
+  BENCH("triangle_fill",          panel.triangle(2, 1, MAXX - 3, 5, 9, MAXY, Uno_HUB75_Driver::GREEN, true));
+  BENCH("triangle_outline",       panel.triangle(2, 1, MAXX - 3, 5, 9, MAXY, Uno_HUB75_Driver::GREEN, false));
+  BENCH("polygon_fill",           panel.polygon(hexagon, 6, Uno_HUB75_Driver::GREEN, true));
+
+  // text
+  BENCH("drawChar",               panel.drawChar(2, 10, 'A', Uno_HUB75_Driver::YELLOW));
+  BENCH("drawChar_clipped",       panel.drawChar(-3, 10, 'A', Uno_HUB75_Driver::YELLOW));
+  BENCH("drawString",             panel.drawString(0, 10, "Hello World!", Uno_HUB75_Driver::YELLOW));
+  BENCH("drawText",               panel.drawText(0, 10, F("Hello World!"), Uno_HUB75_Driver::YELLOW));
+  BENCH("textWidth",              panel.textWidth(F("Hello World!")));
+
+  // sprites
+  BENCH("drawSprite_1bpp",        panel.drawSprite(4, 10, &icon1, 0, Uno_HUB75_Driver::CYAN));
+  BENCH("drawSprite_3bpp",        panel.drawSprite(4, 10, &icon3));
+  BENCH("drawSprite_clipped",     panel.drawSprite(-4, 10, &icon3));
+
+  // animation; a whole frame, then one that only has changes
+#if BUFFCOLS == 32 && PLANES * SCANROWS == 8 && !HUB75_BITPLANE
+  uint16_t frame = 0;
+  BENCH("drawAnimation_first",    panel.drawAnimation(&bars, frame));
+  BENCH("drawAnimation_next",     panel.drawAnimation(&bars, frame));
+#endif
+
+  // regions
+  BENCH("copyPixel",              panel.copyPixel(1, 1, 2, 2));
+  BENCH("copyRegion",             panel.copyRegion(src, dst));
+  BENCH("copyRegion_overlap",     panel.copyRegion(dst, src));
+
+  Uno_HUB75_Driver::Rect all = {0, 0, MAXX, MAXY};
+  Uno_HUB75_Driver::Rect chart = {4, 2, MAXX - 4, MAXY - 2};
+  BENCH("scrollRegion_left",      panel.scrollRegion(all, -1, 0, Uno_HUB75_Driver::BLACK));
+  BENCH("scrollRegion_up",        panel.scrollRegion(all, 0, -1, Uno_HUB75_Driver::BLACK));
+  BENCH("scrollRegion_part",      panel.scrollRegion(chart, -1, 0, Uno_HUB75_Driver::BLACK));
+
+#if HUB75_DISPLAY_LIST
+  // display list: a frame, a label and a reading, drawn in full,
+  // then with nothing changed, then with the reading changed
+  static uint8_t items[48];
+  static char reading[] = "21.5";
+  Uno_HUB75_DisplayList list(panel, items, sizeof(items));
+
+  list.addRect(0, 0, MAXX, MAXY, Uno_HUB75_Driver::BLUE);
+  list.addText(2, MAXY - 1, F("TEMP"), Uno_HUB75_Driver::CYAN);
+  Uno_HUB75_DisplayList::Handle value = list.addText(2, 7, reading, Uno_HUB75_Driver::YELLOW);
+
+#if HUB75_PAGE_FLIP
+  while (panel.flipPending())
+  {
+    panel.update();
+  }
+#endif
+  BENCH("list_refresh_all",       list.refresh());
+#if HUB75_PAGE_FLIP
+  while (panel.flipPending())
+  {
+    panel.update();
+  }
+#endif
+  BENCH("list_refresh_idle",      list.refresh());
+
+  reading[3] = '6';
+  list.changed(value);
+  BENCH("list_refresh_change",    list.refresh());
+#endif
+
+  Serial.println(F("done"));
+  Serial.flush();
+
+  // simavr quits when the CPU sleeps with interrupts off
+  cli();
+  sleep_enable();
+  sleep_cpu();
+}
+
+void loop()
+{
+}
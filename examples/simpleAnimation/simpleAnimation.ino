@@ -173,18 +173,22 @@ void bouncingBlock()
 }
 
 /**********************************************
-* TIMER 2 ISR
+* HUB75 TIMER ISR
 ***********************************************
-* This example is using the hardware Timer 2
-* for updating the panel, so we need to include
-* this ISR (Interrupt Service Routine).
+* This example is using the HUB75 timer (Timer 2,
+* or Timer 3 on a Leonardo) for updating the
+* panel, so we need to include this ISR
+* (Interrupt Service Routine).
 *
 * If you choose the "interrupt" method and forget
 * to include the ISR, your Arduino board will 
 * reset because there is no entry in the vector
 * table!
+*
+* HUB75_TIMER_VECT is TIMER2_COMPA_vect, or
+* TIMER3_COMPA_vect on a Leonardo
 ************************************************/
-ISR(TIMER2_COMPA_vect, ISR_BLOCK)
+ISR(HUB75_TIMER_VECT, ISR_BLOCK)
 {
   // output the contents of the active framebuffer
   // to the physical panel using GPIO pins
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+##########################################################
+# compare.py
+##########################################################
+# Compare the output of examples/benchmark with a stored
+# baseline.
+#
+#   compare.py [--update] [--tolerance PCT] results baseline
+#
+# Prints every measurement with its baseline and the
+# change, and exits with 1 if any of them is more than
+# PCT percent (default 1) slower, or 2 if there is no
+# baseline yet (or it's empty).  With --update the results are written to
+# the baseline file instead.
+##########################################################
+import argparse
+import re
+import sys
+
+LINE = re.compile(r'^([A-Za-z_][A-Za-z0-9_]*) (\d+)$')
+ANSI = re.compile(r'\x1b\[[0-9;]*m')
+
+
+def parse(path):
+    """Name -> cycles, from benchmark output or a baseline.
+
+    Whatever else simavr prints is skipped.
+    """
+    results = {}
+    done = False
+    with open(path) as f:
+        for raw in f:
+            line = ANSI.sub('', raw).strip()
+            if line.endswith('done'):
+                done = True
+                continue
+            # simavr may put a prefix in front of the UART text
+            m = LINE.match(line) or LINE.match(line.split(':')[-1].strip())
+            if m:
+                results[m.group(1)] = int(m.group(2))
+    return results, done
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--update', action='store_true',
+                    help='write the results as the new baseline')
+    ap.add_argument('--tolerance', type=float, default=1.0,
+                    help='percent slower allowed before failing')
+    ap.add_argument('results')
+    ap.add_argument('baseline')
+    args = ap.parse_args()
+
+    now, done = parse(args.results)
+    if not done or not now:
+        sys.exit('%s: benchmark did not finish' % args.results)
+
+    if args.update:
+        with open(args.baseline, 'w') as f:
+            for name, cycles in now.items():
+                f.write('%s %d\n' % (name, cycles))
+        print('wrote %d results to %s' % (len(now), args.baseline))
+        return 0
+
+    try:
+        base, _ = parse(args.baseline)
+    except FileNotFoundError:
+        base = {}
+    if not base:
+        for name, cycles in now.items():
+            print('%-24s %10d' % (name, cycles))
+        print('no baseline yet; run again with -u to store one')
+        return 2
+
+    slower = 0
+    print('%-24s %10s %10s %8s' % ('', 'baseline', 'now', 'change'))
+    for name, cycles in now.items():
+        if name not in base:
+            print('%-24s %10s %10d %8s' % (name, '-', cycles, 'new'))
+            continue
+
+        was = base[name]
+        change = 100.0 * (cycles - was) / was if was else 0.0
+        flag = ''
+        if change > args.tolerance:
+            flag = '  SLOWER'
+            slower += 1
+        print('%-24s %10d %10d %+7.1f%%%s' % (name, was, cycles, change, flag))
+
+    for name in base:
+        if name not in now:
+            print('%-24s %10d %10s %8s' % (name, base[name], '-', 'gone'))
+
+    return 1 if slower else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,92 @@
+#!/bin/sh
+##########################################################
+# run.sh
+##########################################################
+# Build examples/benchmark, run it under simavr, and check
+# the cycle counts against a stored baseline.
+#
+#   extras/benchmark/run.sh [-u] [-b board] name [-DOPTION=value ...]
+#   extras/benchmark/run.sh [-u] all
+#
+#   -u        store the results as the new baseline
+#   -b board  uno (default) or mega
+#   name      which baseline to use, one per set of options;
+#             baselines/<board>-<name>.txt
+#   -D...     compile-time options (see Uno_HUB75_Config.h)
+#   all       every board and name in 'configs' below, each
+#             with its own options
+#
+# Needs arduino-cli (with the arduino:avr core), simavr
+# and python3.  Exits non-zero if anything got slower, or
+# (before building anything) if there's no baseline for
+# the board and name yet and -u wasn't given.
+##########################################################
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+
+update=""
+board=uno
+while getopts "ub:" opt; do
+  case $opt in
+    u) update="--update" ;;
+    b) board=$OPTARG ;;
+    *) exit 2 ;;
+  esac
+done
+shift $((OPTIND - 1))
+
+name=${1:?usage: run.sh [-u] [-b board] name [-DOPTION=value ...]}
+shift
+flags="$*"
+
+# the baselines kept in baselines/: board, name, options
+configs="uno default
+uno scanline -DHUB75_SCANLINE_ISR=1
+uno bitplane -DHUB75_BITPLANE=1
+mega default
+mega bcm4 -DHUB75_BCM_BITS=4"
+
+if [ "$name" = all ]; then
+  failed=0
+  while read -r b n f; do
+    echo "== $b $n${f:+ $f}"
+    "$0" ${update:+-u} -b "$b" "$n" $f < /dev/null || failed=1
+  done <<EOF
+$configs
+EOF
+  exit $failed
+fi
+
+case $board in
+  uno)  fqbn=arduino:avr:uno;  mcu=atmega328p ;;
+  mega) fqbn=arduino:avr:mega; mcu=atmega2560 ;;
+  *)    echo "unknown board $board" >&2; exit 2 ;;
+esac
+
+baseline="$here/baselines/$board-$name.txt"
+
+# without one there's nothing to compare with, which
+# shouldn't pass for a check that nothing got slower
+if [ -z "$update" ] && [ ! -s "$baseline" ]; then
+  echo "no baseline $baseline" >&2
+  echo "store one from a known good commit first: run.sh -u -b $board $name${flags:+ $flags}" >&2
+  exit 2
+fi
+
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+# the library's .cpp files are compiled on their own, so the
+# options have to go to every file, not just the sketch
+arduino-cli compile --fqbn "$fqbn" --library "$repo" \
+  --build-property "compiler.cpp.extra_flags=$flags" \
+  --output-dir "$build" "$repo/examples/benchmark" >/dev/null
+
+# the sketch puts the CPU to sleep with interrupts off when
+# it's done, which makes simavr quit
+timeout 120 simavr -m "$mcu" -f 16000000 "$build/benchmark.ino.elf" > "$build/out.txt" 2>&1
+
+mkdir -p "$here/baselines"
+python3 "$here/compare.py" $update "$build/out.txt" "$baseline"
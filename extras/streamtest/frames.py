@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+##########################################################
+# frames.py
+##########################################################
+# Pack and encode a set of test frames with
+# hub75stream.py, write the stream to a file, and print
+# what the panel should show after each commit, the way
+# streamtest prints it.
+#
+#   frames.py [--planes N] [--mirror-y] STREAM_FILE
+#
+# What should be shown comes from the pixels, not from
+# unpacking the stream, so the packing is checked too.
+# Only the most significant bit-plane can be compared;
+# that's all getPixel() returns.
+#
+# The frames are the test pattern 'send' uses (every row
+# changes, so each is a FRAME packet), then single pixels
+# changing (ROW packets, one a bit-plane), then the same
+# frame again (a COMMIT on its own), then the pattern.
+##########################################################
+import argparse
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                '..', 'tools'))
+import hub75stream  # noqa: E402
+
+
+def test_frames(layout):
+    top = (1 << layout.planes) - 1
+    frames = list(hub75stream.demo_frames(layout, 4))
+    pixels = [list(row) for row in frames[-1]]
+    for f in range(12):
+        x = f * 7 % layout.cols
+        y = f * 5 % layout.rows
+        level = f % top + 1
+        pixels[y][x] = tuple(level if (f + 1) >> c & 1 else 0 for c in range(3))
+        frames.append([list(row) for row in pixels])
+    frames.append(frames[-1])
+    frames.append(frames[-1])
+    frames += list(hub75stream.demo_frames(layout, 2))
+    return frames
+
+
+def shown(layout, pixels):
+    p = layout.planes - 1
+    return [''.join(hub75stream.NAMES[(r >> p & 1) | (g >> p & 1) << 1 | (b >> p & 1) << 2]
+                    for r, g, b in row)
+            for row in pixels]
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--planes', type=int, default=1, choices=(1, 2, 3, 4))
+    ap.add_argument('--mirror-y', action='store_true')
+    ap.add_argument('stream')
+    args = ap.parse_args()
+
+    layout = hub75stream.Layout(32, 16, args.planes, args.mirror_y)
+    stream = bytearray()
+    prev = None
+    for n, pixels in enumerate(test_frames(layout)):
+        frame = layout.pack(pixels)
+        stream += hub75stream.encode(layout, prev, frame)
+        prev = frame
+        print('frame %d' % (n + 1))
+        print('\n'.join(shown(layout, pixels)))
+    print('errors 0')
+
+    with open(args.stream, 'wb') as f:
+        f.write(stream)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,97 @@
+/**********************************************************
+ * Arduino.h
+ **********************************************************
+ * Just enough of the Arduino core and the ATmega328P's
+ * registers to build the library on the host for
+ * streamtest.  The registers are plain variables, defined
+ * in streamtest.cpp, except UDR0, which hands what the
+ * library sends to streamtest.
+ *
+ * Interrupts aren't mocked; streamtest calls the ISRs
+ * itself, one at a time, so cli() and sei() do nothing.
+**********************************************************/
+#ifndef MOCK_ARDUINO_H_
+#define MOCK_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define __AVR_ATmega328P__ 1
+#define F_CPU 16000000UL
+
+// the USART data register; reading it gets the last byte
+// received, and writing it sends one
+struct MockUdr
+{
+  uint8_t rx;
+  MockUdr& operator=(uint8_t b);
+  operator uint8_t() const { return (rx); }
+};
+
+extern MockUdr UDR0;
+
+extern volatile uint8_t PORTB, PORTC, PORTD, PINB, DDRB, DDRC, DDRD;
+extern volatile uint8_t TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK0, SREG;
+extern volatile uint16_t TCNT1;
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+extern volatile uint16_t UBRR0;
+
+#define WGM21   1
+#define CS20    0
+#define CS21    1
+#define CS22    2
+#define CS10    0
+#define OCIE2A  1
+#define OCIE2B  2
+#define OCF2A   1
+#define OCF2B   2
+#define TOIE2   0
+
+#define U2X0    1
+#define UCSZ00  1
+#define UCSZ01  2
+#define DOR0    3
+#define FE0     4
+#define TXEN0   3
+#define RXEN0   4
+#define TXCIE0  6
+#define RXCIE0  7
+
+#define ISR(vector, ...) extern "C" void vector(void)
+#define ISR_BLOCK
+#define ISR_NAKED
+#define reti()
+#define cli()
+#define sei()
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+typedef const char* PGM_P;
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+
+#define bit(b) (1UL << (b))
+#define bitSet(v, b) ((v) |= bit(b))
+#define bitClear(v, b) ((v) &= ~bit(b))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+#define LOW     0
+#define HIGH    1
+#define OUTPUT  1
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline void delayMicroseconds(unsigned int) {}
+inline unsigned long micros() { return (0); }
+inline unsigned long millis() { return (0); }
+
+#endif // MOCK_ARDUINO_H_
@@ -0,0 +1,56 @@
+#!/bin/sh
+##########################################################
+# run.sh
+##########################################################
+# Check hub75stream.py against the library itself: build
+# Uno_HUB75_Stream.cpp and the rest of the library for the
+# host, with the registers mocked (mock/Arduino.h), feed it
+# a stream packed by the tool (frames.py), and compare
+# what the panel shows after every commit with the frames
+# the tool was given.
+#
+#   extras/streamtest/run.sh
+#
+# Runs a 32x16 panel in 8 colors, with 4 levels
+# (HUB75_BCM_BITS 2) and with HUB75_XFORM_MIRROR_Y.  Needs
+# g++ and python3; not the panel, or the Arduino tools.
+# Exits non-zero if anything differs.
+##########################################################
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+failed=0
+
+# run.sh's one test: name, frames.py options, then -D options
+check()
+{
+  name=$1
+  tool=$2
+  shift 2
+
+  g++ -std=gnu++11 -Wall -I"$here/mock" -I"$repo/src" -DARDUINO_ARCH_AVR \
+    -DHUB75_PAGE_FLIP=1 -DHUB75_STREAM=1 "$@" \
+    "$here/streamtest.cpp" "$repo"/src/*.cpp -o "$build/streamtest"
+
+  python3 "$here/frames.py" $tool "$build/stream.bin" > "$build/want.txt"
+  "$build/streamtest" < "$build/stream.bin" > "$build/got.txt"
+
+  if cmp -s "$build/want.txt" "$build/got.txt"; then
+    echo "$name: ok"
+  else
+    echo "$name: FAILED"
+    diff "$build/want.txt" "$build/got.txt" | head -20
+    failed=1
+  fi
+}
+
+check 8-color ""
+check bcm-2 "--planes 2" -DHUB75_BCM_BITS=2
+check mirror-y "--mirror-y" -DHUB75_TRANSFORM=HUB75_XFORM_MIRROR_Y
+
+exit $failed
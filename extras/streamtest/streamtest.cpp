@@ -0,0 +1,161 @@
+/**********************************************************
+ * streamtest.cpp
+ **********************************************************
+ * The library built on the host (see run.sh), fed a
+ * stream from stdin through the USART receive ISR, the way
+ * a panel running with HUB75_STREAM would get it.
+ *
+ * Every time the panel sends an ACK, it prints what
+ * getPixel() sees, one letter per pixel as hub75stream.py
+ * decode does, and at the end the streamErrors() count.
+ *
+ * While a flip is waiting, half a ring's worth of bytes
+ * more is received before update() gets to run, so they
+ * go through the ring and are put in the drawing buffer by
+ * the transmit complete ISR, as they would be on a panel.
+ * Until then the drawing buffer is the one on the panel,
+ * and if any of those bytes changed it, that's printed
+ * too.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+#include <stdio.h>
+
+extern "C" void USART_RX_vect(void);
+extern "C" void USART_TX_vect(void);
+
+volatile uint8_t PORTB, PORTC, PORTD, PINB, DDRB, DDRC, DDRD;
+volatile uint8_t TCCR2A, TCCR2B, OCR2A, OCR2B, TCNT2, TIMSK2, TIFR2;
+volatile uint8_t TCCR1A, TCCR1B, TIMSK0, SREG;
+volatile uint16_t TCNT1;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C;
+volatile uint16_t UBRR0;
+MockUdr UDR0;
+
+static Uno_HUB75_Driver panel;
+
+// a byte went out, and its transmit complete ISR is due
+static bool sent = false;
+static uint16_t frames = 0;
+
+static const char names[] = ".RGYBMCW";
+
+// the panel as getPixel() sees it, a line per row
+static char seen[HEIGHT][WIDTH + 1];
+static char before[HEIGHT][WIDTH + 1];
+
+static void look()
+{
+  for (int16_t y = 0; y < HEIGHT; ++y)
+  {
+    for (int16_t x = 0; x < WIDTH; ++x)
+    {
+      seen[y][x] = names[panel.getPixel(x, y)];
+    }
+
+    seen[y][WIDTH] = 0;
+  }
+}
+
+/********************************************************
+* MockUdr::operator=()
+*********************************************************
+* The library sent a byte.  An ACK means the frame is on
+* the panel, so print it now; once the ISR sending it
+* returns, the ring may already hold the next frame.  The
+* drawing buffer is brought up to date first, as
+* streamDrain() would
+********************************************************/
+MockUdr& MockUdr::operator=(uint8_t b)
+{
+  sent = true;
+
+  if (b != HUB75_STREAM_ACK)
+  {
+    return (*this);
+  }
+
+  panel.flipPending();
+  look();
+
+  printf("frame %u\n", ++frames);
+
+  for (int16_t y = 0; y < HEIGHT; ++y)
+  {
+    puts(seen[y]);
+  }
+
+  return (*this);
+}
+
+/********************************************************
+* settle()
+*********************************************************
+* Run update() until the waiting frame is shown, and the
+* transmit complete ISR for every byte sent.  Draining the
+* ring can commit another frame, so keep at it until
+* there's nothing left to do
+********************************************************/
+static void settle()
+{
+  for (;;)
+  {
+    if (sent)
+    {
+      sent = false;
+      USART_TX_vect();
+    }
+    else if (panel.flipPending())
+    {
+      panel.update();
+    }
+    else
+    {
+      return;
+    }
+  }
+}
+
+int main()
+{
+  uint8_t held = 0;
+  int c;
+
+  panel.begin(false);
+  panel.beginStream();
+
+  while ((c = getchar()) != EOF)
+  {
+    UDR0.rx = c;
+    USART_RX_vect();
+
+    if (panel.flipPending())
+    {
+      if (!held)
+      {
+        look();
+        memcpy(before, seen, sizeof(seen));
+      }
+
+      if (++held < HUB75_STREAM_RING / 2)
+      {
+        continue;
+      }
+
+      look();
+
+      if (memcmp(before, seen, sizeof(seen)))
+      {
+        printf("drawn on while shown\n");
+      }
+    }
+
+    held = 0;
+    settle();
+  }
+
+  settle();
+
+  printf("errors %u\n", panel.streamErrors());
+
+  return (0);
+}
@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+##########################################################
+# hub75stream.py
+##########################################################
+# Send frames to a panel running with HUB75_STREAM, or
+# decode a stream to check what would be shown.
+#
+#   hub75stream.py send [options] PORT [image ...]
+#   hub75stream.py decode [options] PORT_OR_FILE
+#
+# send packs each frame the way the framebuffer is laid
+# out and sends only the rows that changed since the last
+# one (or the whole frame, if most did).  With no images
+# it sends a moving test pattern.  Images need Pillow; an
+# animated GIF is a frame per GIF frame.  PORT can be a
+# serial port (with pyserial), a pty, or a file.
+#
+# decode reads a stream and prints every committed frame
+# as text, one letter per pixel (the first letter of the
+# color; '.' for black).  Point send at one end of a pty
+# pair and decode at the other to try it without a panel:
+#
+#   socat -d -d pty,raw,echo=0 pty,raw,echo=0
+#   hub75stream.py decode /dev/pts/3 &
+#   hub75stream.py --count 5 send /dev/pts/2
+#
+# decode is a copy of the panel's state machine in Python;
+# extras/streamtest checks what send packs against the
+# library itself.
+#
+# The geometry options have to match the sketch's build:
+# --cols is BUFFCOLS (32 a panel in the chain, or
+# HUB75_VIRTUAL_COLS), --rows is HUB75_PANEL_ROWS and
+# --planes is HUB75_BCM_BITS (1 for 8 colors).  Only
+# panels with one row address per row in each half (1/8
+# scan for 16 rows, 1/16 for 32), in one row of panels,
+# are packed.  --mirror-y matches HUB75_XFORM_MIRROR_Y.
+##########################################################
+import argparse
+import os
+import sys
+import time
+
+FRAME = 0x01
+ROW = 0x02
+COMMIT = 0x03
+ACK = 0x06
+
+NAMES = '.RGYBMCW'
+
+
+class Layout:
+    """Packs pixels into framebuffer bytes, and back."""
+
+    def __init__(self, cols, rows, planes, mirror_y):
+        self.cols = cols
+        self.rows = rows
+        self.scan = rows // 2
+        self.planes = planes
+        self.mirror_y = mirror_y
+        self.size = planes * self.scan * cols
+
+    def pack(self, pixels):
+        """pixels[y][x] = (r, g, b) levels, 0 to 2^planes - 1."""
+        buf = bytearray(self.size)
+        for y in range(self.rows):
+            by = self.rows - 1 - y if self.mirror_y else y
+            row, shift = (by, 2) if by < self.scan else (by - self.scan, 5)
+            for x in range(self.cols):
+                r, g, b = pixels[y][x]
+                for p in range(self.planes):
+                    code = ((r >> p) & 1) | ((g >> p) & 1) << 1 | ((b >> p) & 1) << 2
+                    buf[(p * self.scan + row) * self.cols + x] |= code << shift
+        return bytes(buf)
+
+    def unpack(self, buf):
+        """The most significant bit-plane, as color letters."""
+        p = self.planes - 1
+        lines = []
+        for y in range(self.rows):
+            by = self.rows - 1 - y if self.mirror_y else y
+            row, shift = (by, 2) if by < self.scan else (by - self.scan, 5)
+            base = (p * self.scan + row) * self.cols
+            lines.append(''.join(NAMES[(buf[base + x] >> shift) & 7]
+                                 for x in range(self.cols)))
+        return lines
+
+
+def encode(layout, prev, frame):
+    """Packets that turn 'prev' (None at first) into 'frame'."""
+    n = layout.cols
+    rows = layout.planes * layout.scan
+    changed = [r for r in range(rows)
+               if prev is None or prev[r * n:(r + 1) * n] != frame[r * n:(r + 1) * n]]
+    out = bytearray()
+    if len(changed) * 2 > rows:
+        out.append(FRAME)
+        out += frame
+    else:
+        for r in changed:
+            out.append(ROW | r << 2)
+            out += frame[r * n:(r + 1) * n]
+    out.append(COMMIT)
+    return bytes(out)
+
+
+def decode(layout, data, state):
+    """Feed bytes through the same state machine as the panel.
+
+    'state' is a dict carried between calls; returns the
+    frames committed in 'data'.
+    """
+    buf = state.setdefault('buf', bytearray(layout.size))
+    frames = []
+    for b in data:
+        if not b & 0x03:
+            if state.get('pos', 0) < state.get('end', 0):
+                buf[state['pos']] = b
+                state['pos'] += 1
+            continue
+        if state.get('pos', 0) != state.get('end', 0):
+            state['errors'] = state.get('errors', 0) + 1
+        state['pos'] = state['end'] = 0
+        if b & 0x03 == FRAME:
+            state['end'] = layout.size
+        elif b & 0x03 == ROW:
+            row = b >> 2
+            if row < layout.planes * layout.scan:
+                state['pos'] = row * layout.cols
+                state['end'] = state['pos'] + layout.cols
+            else:
+                state['errors'] = state.get('errors', 0) + 1
+        else:
+            frames.append(bytes(buf))
+    return frames
+
+
+def demo_frames(layout, count):
+    """Diagonal color bars moving one pixel a frame."""
+    top = (1 << layout.planes) - 1
+    for f in range(count):
+        pixels = []
+        for y in range(layout.rows):
+            row = []
+            for x in range(layout.cols):
+                code = ((x + y + f) // 4) % 8
+                row.append(tuple(top if code >> c & 1 else 0 for c in range(3)))
+            pixels.append(row)
+        yield pixels
+
+
+def image_frames(layout, paths):
+    try:
+        from PIL import Image, ImageSequence
+    except ImportError:
+        sys.exit('images need Pillow: pip install pillow')
+    shift = 8 - layout.planes
+    for path in paths:
+        for im in ImageSequence.Iterator(Image.open(path)):
+            im = im.convert('RGB').resize((layout.cols, layout.rows))
+            px = im.load()
+            yield [[tuple(v >> shift for v in px[x, y]) for x in range(layout.cols)]
+                   for y in range(layout.rows)]
+
+
+def open_port(path, baud, write):
+    """A serial port through pyserial if there is one, else raw."""
+    try:
+        import serial
+        # a pty has no baud rate; only real ports go to pyserial
+        if not os.path.basename(path).isdigit() and os.path.exists(path):
+            fd = os.open(path, os.O_RDONLY | os.O_NONBLOCK)
+            real = os.isatty(fd)
+            os.close(fd)
+            if real:
+                return serial.Serial(path, baud, timeout=1)
+    except ImportError:
+        pass
+    if write and not os.path.exists(path):
+        return open(path, 'wb')
+    fd = os.open(path, os.O_RDWR if write else os.O_RDONLY)
+    if os.isatty(fd):
+        import tty
+        tty.setraw(fd)
+    return os.fdopen(fd, 'r+b' if write else 'rb', buffering=0)
+
+
+def wait_ack(port, timeout=1.0):
+    end = time.time() + timeout
+    while time.time() < end:
+        b = port.read(1)
+        if b and b[0] == ACK:
+            return True
+    return False
+
+
+def send(args, layout):
+    frames = image_frames(layout, args.images) if args.images else demo_frames(layout, args.count)
+    port = open_port(args.port, args.baud, True)
+    prev = None
+    sent = 0
+    start = time.time()
+    for n, pixels in enumerate(frames):
+        frame = layout.pack(pixels)
+        port.write(encode(layout, prev, frame))
+        port.flush()
+        prev = frame
+        sent += 1
+        if args.ack and not wait_ack(port):
+            sys.exit('no ACK for frame %d' % n)
+        if args.fps:
+            delay = start + sent / args.fps - time.time()
+            if delay > 0:
+                time.sleep(delay)
+    print('%d frames in %.2f s' % (sent, time.time() - start), file=sys.stderr)
+
+
+def show(args, layout):
+    port = open_port(args.port, args.baud, False)
+    state = {}
+    count = 0
+    while True:
+        data = port.read(4096)
+        if not data:
+            break
+        for frame in decode(layout, data, state):
+            count += 1
+            print('frame %d, errors %d' % (count, state.get('errors', 0)))
+            print('\n'.join(layout.unpack(frame)))
+            sys.stdout.flush()
+            if args.count and count >= args.count:
+                return
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--cols', type=int, default=32, help='BUFFCOLS')
+    ap.add_argument('--rows', type=int, default=16, choices=(16, 32),
+                    help='HUB75_PANEL_ROWS')
+    ap.add_argument('--planes', type=int, default=1, choices=(1, 2, 3, 4),
+                    help='HUB75_BCM_BITS, or 1')
+    ap.add_argument('--mirror-y', action='store_true',
+                    help='the sketch uses HUB75_XFORM_MIRROR_Y')
+    ap.add_argument('--baud', type=int, default=500000)
+    ap.add_argument('--count', type=int, default=0,
+                    help='frames to send (test pattern) or decode; 0 is no limit')
+    sub = ap.add_subparsers(dest='cmd', required=True)
+    sp = sub.add_parser('send')
+    sp.add_argument('--fps', type=float, default=30)
+    sp.add_argument('--ack', action='store_true',
+                    help='wait for the panel to show each frame')
+    sp.add_argument('port')
+    sp.add_argument('images', nargs='*')
+    dp = sub.add_parser('decode')
+    dp.add_argument('port')
+    args = ap.parse_args()
+
+    if args.cmd == 'send' and not args.images and not args.count:
+        args.count = 300
+
+    layout = Layout(args.cols, args.rows, args.planes, args.mirror_y)
+    if args.cmd == 'send':
+        send(args, layout)
+    else:
+        show(args, layout)
+
+
+if __name__ == '__main__':
+    main()
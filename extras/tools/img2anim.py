@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+##########################################################
+# img2anim.py
+##########################################################
+# Convert an animated GIF, or a sequence of images, to an
+# animation for drawAnimation(), as a C header.
+#
+#   img2anim.py [--name NAME] [--cols N] [--rows 16|32]
+#               [--planes N] [--mirror-y] [--delay MS]
+#               image [image ...] out.h
+#
+# Every frame of every image is a frame of the animation,
+# in order, scaled to the panel.  A GIF's own frame times
+# are kept; other images are shown for --delay ms
+# (default 100).  Frame times are stored in 10 ms units,
+# up to 2.55 s; a frame the same as the one before only
+# makes that one last longer.
+#
+# The animation is packed for one build's framebuffer, so
+# the geometry options have to match the sketch's build,
+# the same as for hub75stream.py: --cols is BUFFCOLS,
+# --rows is HUB75_PANEL_ROWS, --planes is HUB75_BCM_BITS
+# (1 for 8 colors) and --mirror-y matches
+# HUB75_XFORM_MIRROR_Y.  drawAnimation() draws nothing
+# for a build it doesn't fit.
+#
+#   #include "clip.h"
+#   uint16_t frame = 0;
+#   ...
+#   delay(panel.drawAnimation(&clip, frame));
+#
+# With --background, the first frame is written as it is
+# laid out in the framebuffer instead, for setBackground()
+# (HUB75_LAYERS):
+#
+#   #include "dash.h"
+#   panel.setBackground(dash, true);
+##########################################################
+import argparse
+import os
+import re
+import sys
+
+from hub75stream import Layout
+
+try:
+    from PIL import Image, ImageSequence
+except ImportError:
+    sys.exit('img2anim.py needs Pillow: pip install pillow')
+
+LITERAL = 0x00
+REPEAT = 0x01
+SKIP = 0x02
+FILL = 0x03
+MAX_COUNT = 64
+
+
+def load_frames(layout, paths, delay):
+    """(packed frame, ms) for every frame of every image."""
+    shift = 8 - layout.planes
+    frames = []
+    for path in paths:
+        for im in ImageSequence.Iterator(Image.open(path)):
+            ms = im.info.get('duration') or delay
+            im = im.convert('RGB').resize((layout.cols, layout.rows))
+            px = im.load()
+            pixels = [[tuple(v >> shift for v in px[x, y]) for x in range(layout.cols)]
+                      for y in range(layout.rows)]
+            frames.append((layout.pack(pixels), ms))
+    return frames
+
+
+def encode_row(cur, prev):
+    """Codes for one buffer row; prev is None for a whole row."""
+    out = []
+    last = 0
+    i = 0
+    n = len(cur)
+    while i < n:
+        # the rest of the row is the last byte
+        if all(b == last for b in cur[i:]):
+            out.append(FILL)
+            break
+        same = 0
+        if prev is not None:
+            while i + same < n and cur[i + same] == prev[i + same]:
+                same += 1
+        run = 0
+        while i + run < n and cur[i + run] == last:
+            run += 1
+        if same and same >= run:
+            count = min(same, MAX_COUNT)
+            out.append((count - 1) << 2 | SKIP)
+        elif run:
+            count = min(run, MAX_COUNT)
+            out.append((count - 1) << 2 | REPEAT)
+        else:
+            count = 1
+            last = cur[i]
+            out.append(last)
+        i += count
+    return out
+
+
+def encode_frame(layout, cur, prev, ticks):
+    """A frame: time, row mask, then the rows in it."""
+    n = layout.cols
+    rows = layout.planes * layout.scan
+    mask = [0] * ((rows + 7) // 8)
+    body = []
+    for r in range(rows):
+        row = cur[r * n:(r + 1) * n]
+        old = None if prev is None else prev[r * n:(r + 1) * n]
+        if old == row:
+            continue
+        mask[r >> 3] |= 1 << (r & 7)
+        body += encode_row(row, old)
+    return [ticks] + mask + body
+
+
+def write_background(args, name, layout, packed):
+    """The framebuffer bytes of one frame, as they are."""
+    lines = ['// %s: background for %d columns, %d buffer rows; made by img2anim.py'
+             % (os.path.basename(args.images[0]), layout.cols, layout.planes * layout.scan),
+             '#include <Uno_HUB75_Driver.h>',
+             '',
+             'static const uint8_t %s[] PROGMEM =' % name,
+             '{']
+    for i in range(0, len(packed), 12):
+        lines.append('  ' + ', '.join('0x%02x' % b for b in packed[i:i + 12]) + ',')
+    lines += ['};', '']
+    with open(args.out, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--name', help='C name (default: from the first file name)')
+    ap.add_argument('--cols', type=int, default=32, help='BUFFCOLS')
+    ap.add_argument('--rows', type=int, default=16, choices=(16, 32),
+                    help='HUB75_PANEL_ROWS')
+    ap.add_argument('--planes', type=int, default=1, choices=(1, 2, 3, 4),
+                    help='HUB75_BCM_BITS, or 1')
+    ap.add_argument('--mirror-y', action='store_true',
+                    help='the sketch uses HUB75_XFORM_MIRROR_Y')
+    ap.add_argument('--delay', type=int, default=100,
+                    help='ms a frame, for images without their own')
+    ap.add_argument('--background', action='store_true',
+                    help='a still framebuffer for setBackground(), not an animation')
+    ap.add_argument('images', nargs='+')
+    ap.add_argument('out', help='header to write')
+    args = ap.parse_args()
+
+    # BUFFCOLS is at most 256 (HUB75_VIRTUAL_COLS, or 8 panels)
+    if not 1 <= args.cols <= 256:
+        ap.error('--cols is BUFFCOLS, 1 to 256')
+
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.images[0]))[0])
+    layout = Layout(args.cols, args.rows, args.planes, args.mirror_y)
+
+    if args.background:
+        write_background(args, name, layout, load_frames(layout, args.images[:1], 0)[0][0])
+        return
+
+    # fold repeated frames into the time of the one before
+    frames = []
+    for packed, ms in load_frames(layout, args.images, args.delay):
+        ticks = max(1, min(255, (ms + 5) // 10))
+        if frames and frames[-1][0] == packed and frames[-1][1] + ticks <= 255:
+            frames[-1][1] += ticks
+        else:
+            frames.append([packed, ticks])
+
+    data = []
+    index = []
+    prev = None
+    for packed, ticks in frames:
+        index.append(len(data))
+        data += encode_frame(layout, packed, prev, ticks)
+        prev = packed
+    if len(data) > 65535:
+        sys.exit('%s: %d bytes is more than an animation can hold' % (name, len(data)))
+
+    raw = len(frames) * layout.size
+    lines = ['// %s: %d frame(s) for %d columns, %d buffer rows; %d bytes (%d unpacked); '
+             'made by img2anim.py'
+             % (os.path.basename(args.images[0]), len(frames), layout.cols,
+                layout.planes * layout.scan, len(data) + 2 * len(index), raw),
+             '#include <Uno_HUB75_Driver.h>',
+             '',
+             'static const uint8_t %s_data[] PROGMEM =' % name,
+             '{']
+    for i in range(0, len(data), 12):
+        lines.append('  ' + ', '.join('0x%02x' % b for b in data[i:i + 12]) + ',')
+    lines += ['};',
+              '',
+              'static const uint16_t %s_index[] PROGMEM =' % name,
+              '{']
+    for i in range(0, len(index), 8):
+        lines.append('  ' + ', '.join('%d' % o for o in index[i:i + 8]) + ',')
+    lines += ['};',
+              '',
+              'static const Uno_HUB75_Driver::Animation %s PROGMEM =' % name,
+              '{',
+              '  %s_data, %s_index, %d, %d, %d'
+              % (name, name, len(frames), layout.cols, layout.planes * layout.scan),
+              '};',
+              '']
+
+    with open(args.out, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+##########################################################
+# img2sprite.py
+##########################################################
+# Convert an image (PNG, BMP, GIF, anything Pillow reads)
+# to a sprite for drawSprite(), as a C header.
+#
+#   img2sprite.py [--name NAME] [--bpp 1|3] [--frames N]
+#                 [--threshold T] [--key RRGGBB] image [out.h]
+#
+# Frames are side by side in the image, all the same
+# width.  Every channel of a pixel is on if it's at least
+# T (default 128), which gives the 8 colors of the Colors
+# enum.  For --bpp 1, any color other than black is a set
+# bit.  Pixels with alpha under 128, or the --key color,
+# are transparent; in 3bpp they're stored as 8, which
+# isn't one of the colors.
+#
+# The header has the bitmap and the Sprite struct, both in
+# PROGMEM:
+#
+#   #include "icon.h"
+#   panel.drawSprite(0, 7, &icon, frame);
+##########################################################
+import argparse
+import os
+import re
+import sys
+
+try:
+    from PIL import Image
+except ImportError:
+    sys.exit('img2sprite.py needs Pillow: pip install pillow')
+
+CLEAR = 8
+
+
+def pixel_codes(img, threshold, key):
+    """Colors value of every pixel, row by row, CLEAR if transparent."""
+    rgba = img.convert('RGBA')
+    w, h = rgba.size
+    data = rgba.load()
+    rows = []
+    for y in range(h):
+        row = []
+        for x in range(w):
+            r, g, b, a = data[x, y]
+            if a < 128 or (key is not None and (r, g, b) == key):
+                row.append(CLEAR)
+                continue
+            row.append((r >= threshold) |
+                       (g >= threshold) << 1 |
+                       (b >= threshold) << 2)
+        rows.append(row)
+    return rows
+
+
+def pack_row(row, bpp):
+    """One row of a frame, packed like drawSprite() reads it."""
+    out = []
+    if bpp == 1:
+        for i in range(0, len(row), 8):
+            byte = 0
+            for j, code in enumerate(row[i:i + 8]):
+                if code not in (0, CLEAR):
+                    byte |= 0x80 >> j
+            out.append(byte)
+    else:
+        for i in range(0, len(row), 2):
+            pair = row[i:i + 2] + [CLEAR]
+            out.append(pair[0] << 4 | pair[1])
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument('--name', help='C name (default: from the file name)')
+    ap.add_argument('--bpp', type=int, choices=(1, 3), default=3,
+                    help='1 bit a pixel, or one of 8 colors (default)')
+    ap.add_argument('--frames', type=int, default=1,
+                    help='frames side by side in the image')
+    ap.add_argument('--threshold', type=int, default=128,
+                    help='channel level that counts as on')
+    ap.add_argument('--key', help='transparent color, as RRGGBB')
+    ap.add_argument('image')
+    ap.add_argument('out', nargs='?', help='header to write (default: stdout)')
+    args = ap.parse_args()
+
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.image))[0])
+    key = None
+    if args.key:
+        key = tuple(int(args.key[i:i + 2], 16) for i in (0, 2, 4))
+
+    rows = pixel_codes(Image.open(args.image), args.threshold, key)
+    height = len(rows)
+    if args.frames < 1 or len(rows[0]) % args.frames:
+        sys.exit('%s: %d pixels wide does not split into %d frames'
+                 % (args.image, len(rows[0]), args.frames))
+    width = len(rows[0]) // args.frames
+    if width > 255 or height > 255 or args.frames > 255:
+        sys.exit('%s: sprites are at most 255 x 255, 255 frames' % args.image)
+
+    # frames one after another, rows top to bottom
+    data = []
+    for f in range(args.frames):
+        for row in rows:
+            data.extend(pack_row(row[f * width:(f + 1) * width], args.bpp))
+
+    lines = ['// %s: %d x %d, %d frame(s), %dbpp; made by img2sprite.py'
+             % (os.path.basename(args.image), width, height, args.frames, args.bpp),
+             '#include <Uno_HUB75_Driver.h>',
+             '',
+             'static const uint8_t %s_bits[] PROGMEM =' % name,
+             '{']
+    for i in range(0, len(data), 12):
+        lines.append('  ' + ', '.join('0x%02x' % b for b in data[i:i + 12]) + ',')
+    lines += ['};',
+              '',
+              'static const Uno_HUB75_Driver::Sprite %s PROGMEM =' % name,
+              '{',
+              '  %s_bits, %d, %d, %d, Uno_HUB75_Driver::SPRITE_%dBPP, %d'
+              % (name, width, height, args.frames, args.bpp, CLEAR),
+              '};',
+              '']
+
+    text = '\n'.join(lines)
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()
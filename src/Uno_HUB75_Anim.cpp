@@ -0,0 +1,176 @@
+/**********************************************************
+ * @file    Uno_HUB75_Anim.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Animation playback for the Uno_HUB75_Driver class.
+ *
+ * An animation is packed on the host (see
+ * extras/tools/img2anim.py) the way the framebuffer is
+ * laid out, so unpacking a frame is just copying bytes
+ * from FLASH into the drawing buffer.  Only the rows that
+ * changed are stored, and in those, only the bytes that
+ * changed, with runs of the same byte stored once.
+ *
+ * Each frame is:
+ *   a byte with how long to show it, in 10 ms units
+ *   (rows + 7) / 8 bytes with a bit for each buffer row
+ *     that's in the frame, row 0 in bit 0 of the first
+ *   for each of those rows, codes until it's filled in
+ *
+ * Data bytes always have the low 2 bits clear (they're the
+ * serial pins), so those bits tell the codes apart:
+ *   xxxxxx00 - this byte
+ *   nnnnnn01 - the last byte again, n + 1 times
+ *   nnnnnn10 - leave the next n + 1 bytes as they are
+ *   xxxxxx11 - the last byte to the end of the row
+ * "The last byte" starts out as 0 (black) on every row.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+
+#include "Arduino.h"
+
+#define ANIM_REPEAT   0x01
+#define ANIM_SKIP     0x02
+#define ANIM_FILL     0x03
+
+/********************************************************
+* drawAnimation()
+*********************************************************
+* Unpack a frame of an animation into the drawing buffer
+* and draw() it.  The frames only hold what changed since
+* the one before, so play them in order; frame 0 has all
+* of it, so it can always be started over.
+*
+* The animation has to be packed for this build's buffer
+* (BUFFCOLS, and PLANES * SCANROWS rows), and goes in as
+* is; it isn't moved by a translation method.  Anything
+* drawn before is covered by the rows the frame has,
+* except rows clipped by setClipRows().
+* img2anim.py only packs the byte per column layout, so
+* nothing fits a HUB75_BITPLANE build.
+*
+* With page flipping, it first waits for the last frame to
+* be shown (calling update() itself without the ISR).
+*
+* Parameters:
+*   const Uno_HUB75_Driver::Animation* anim - the
+*     animation, in PROGMEM
+*   uint16_t& frame - frame to draw; set to the next one
+* Returns
+*   uint16_t - milliseconds to show the frame for, or 0
+*     if the animation doesn't fit this build
+********************************************************/
+uint16_t Uno_HUB75_Driver::drawAnimation(const Uno_HUB75_Driver::Animation* anim, uint16_t& frame)
+{
+  Uno_HUB75_Driver::Animation a;
+  memcpy_P(&a, anim, sizeof(a));
+
+  if (a.cols != BUFFCOLS || a.rows != PLANES * SCANROWS || !a.frames || HUB75_BITPLANE)
+  {
+    return (0);
+  }
+
+  if (frame >= a.frames)
+  {
+    frame = 0;
+  }
+
+#if HUB75_PAGE_FLIP
+  // the drawing buffer is still on the panel
+  while (this->flipPending())
+  {
+    if (!usingISR)
+    {
+      this->update();
+    }
+  }
+#endif
+
+  const uint8_t* src = a.data + pgm_read_word(&a.index[frame]);
+
+  uint16_t ms = pgm_read_byte(src++) * 10;
+
+  // the row mask is read a byte at a time as the rows go by; the
+  // rows' codes are after all of it
+  const uint8_t* rowBits = src;
+  uint8_t mask = 0;
+
+  src += (PLANES * SCANROWS + 7) / 8;
+
+  for (uint8_t row = 0; row < PLANES * SCANROWS; ++row)
+  {
+    if (!(row & 0x07))
+    {
+      mask = pgm_read_byte(rowBits++);
+    }
+
+    bool inFrame = mask & 0x01;
+    mask >>= 1;
+
+    if (!inFrame)
+    {
+      continue;
+    }
+
+    // same bit for a row in every bit-plane.  A clipped row's
+    // codes still have to be read past, but nothing is written
+#if HUB75_DISPLAY_LIST
+    bool clipped = !(clipRows & bit(row & (SCANROWS - 1)));
+#else
+    const bool clipped = false;
+#endif
+
+    if (!clipped)
+    {
+      dirtyRows |= bit(row & (SCANROWS - 1));
+    }
+
+    uint8_t* dst = pixBuff[row];
+    uint8_t* end = dst + BUFFCOLS;
+    uint8_t last = 0;
+
+    while (dst < end)
+    {
+      uint8_t b = pgm_read_byte(src++);
+      uint8_t code = b & 0x03;
+
+      if (!code)
+      {
+        if (!clipped)
+        {
+          *dst = b;
+        }
+
+        ++dst;
+        last = b;
+        continue;
+      }
+
+      uint8_t n = (b >> 2) + 1;
+
+      // the encoder never runs past the end of the row, but
+      // don't trust it with the rest of RAM
+      if (code == ANIM_FILL || n > end - dst)
+      {
+        n = end - dst;
+      }
+
+      if (code != ANIM_SKIP && !clipped)
+      {
+        memset(dst, last, n);
+      }
+
+      dst += n;
+    }
+  }
+
+  if (++frame >= a.frames)
+  {
+    frame = 0;
+  }
+
+  this->draw();
+
+  return (ms);
+}
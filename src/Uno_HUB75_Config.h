@@ -0,0 +1,451 @@
+/**********************************************************
+ * @file    Uno_HUB75_Config.h
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Compile-time options for the library.
+ *
+ * Every option here can be changed by editing this file,
+ * or by passing a -D flag to the compiler (platformio's
+ * build_flags, or arduino-cli's --build-property).  Note
+ * that a #define in the sketch's .ino file is NOT enough;
+ * the library .cpp files are compiled on their own and
+ * would never see it.
+ *
+ * The defaults give the original behavior of the library:
+ * 8 colors, a 32 X 16 panel with 1/8 scan, 512 bytes of
+ * framebuffer.
+**********************************************************/
+#ifndef PANEL_CONFIG_H_
+#define PANEL_CONFIG_H_
+
+/**********************************************************
+* HUB75_PANEL_COLS, HUB75_PANEL_ROWS
+***********************************************************
+* Size of one panel.  32 X 16 and 32 X 32 are the usual
+* ones; 64 X 32 panels are 2048 bytes of framebuffer, so
+* they need a Mega
+**********************************************************/
+#ifndef HUB75_PANEL_COLS
+#define HUB75_PANEL_COLS 32
+#endif
+
+#ifndef HUB75_PANEL_ROWS
+#define HUB75_PANEL_ROWS 16
+#endif
+
+/**********************************************************
+* HUB75_SCAN, HUB75_SCAN_BLOCK
+***********************************************************
+* How many row addresses the panel has; it lights that many
+* rows one after the other.  The usual indoor panels light
+* one row in each half at a time:
+*
+*   32 X 16, 1/8 scan  - HUB75_SCAN 8 (A, B, C lines)
+*   32 X 32, 1/16 scan - HUB75_SCAN 16 (adds the D line,
+*                        on A0 / PC0)
+*   64 X 32, 1/16 scan - same, with HUB75_PANEL_COLS 64
+*
+* Outdoor panels often light more rows at once, like the
+* 32 X 16, 1/4 scan ones (HUB75_SCAN 4, A and B lines).
+* Each row address then drives several rows in each half,
+* and the shift registers for all of them are chained, in
+* an order that changes from one make to the next.  The
+* drawing methods put each pixel in the right spot with
+* hub75ScanMap() as it's drawn, so update() doesn't do any
+* extra work.  The built-in one handles the common panels
+* that alternate blocks of HUB75_SCAN_BLOCK columns from
+* each row; a sketch can define its own (see the README).
+*
+* The default is half of HUB75_PANEL_ROWS, one row in each
+* half at a time.
+**********************************************************/
+#ifndef HUB75_SCAN
+#define HUB75_SCAN (HUB75_PANEL_ROWS / 2)
+#endif
+
+#ifndef HUB75_SCAN_BLOCK
+#define HUB75_SCAN_BLOCK 8
+#endif
+
+/**********************************************************
+* HUB75_CHAIN, HUB75_CHAIN_ROWS, HUB75_SERPENTINE
+***********************************************************
+* Panels can be daisy-chained, each one's output connector
+* to the next one's input, to make a bigger sign.
+*
+* HUB75_CHAIN is how many panels there are, and
+* HUB75_CHAIN_ROWS is how many rows of panels they are
+* mounted in.  Seen from the front, the Arduino feeds the
+* top right panel and the chain runs right to left.  With
+* more than one row of panels, it then goes to the right
+* end of the next row down, unless HUB75_SERPENTINE is 1.
+* Then it snakes back and forth, and every other row of
+* panels is mounted upside down.
+*
+* Each panel adds 256 bytes to each framebuffer (times the
+* number of BCM bit-planes), and 12 us to shifting a row.
+* See the README for how many panels each board can drive.
+**********************************************************/
+#ifndef HUB75_CHAIN
+#define HUB75_CHAIN 1
+#endif
+
+#ifndef HUB75_CHAIN_ROWS
+#define HUB75_CHAIN_ROWS 1
+#endif
+
+#ifndef HUB75_SERPENTINE
+#define HUB75_SERPENTINE 0
+#endif
+
+/**********************************************************
+* HUB75_BCM_BITS
+***********************************************************
+* Color depth per channel.
+*
+*   0 - classic 8 color mode.  One bit each for red, green
+*       and blue, 256 bytes per framebuffer.
+*   2, 3 or 4 - Binary Code Modulation (BCM).  The frame-
+*       buffer holds this many bit-planes, and each plane
+*       is lit for twice as long as the one before it, so
+*       every channel gets 2^N brightness levels (4, 8 or
+*       16).  Each plane costs another 256 bytes per
+*       framebuffer.  BCM mode needs the HUB75 timer ISR
+*       (Timer 2, or Timer 3 on the 32U4) for proper
+*       weighting.
+*
+* RAM used by both framebuffers:
+*   0 -  512 bytes
+*   2 - 1024 bytes
+*   3 - 1536 bytes (tight on an Uno, but it fits)
+*   4 - 2048 bytes (more than an Uno has - Mega only)
+* (for one panel; multiply by HUB75_CHAIN, and halve
+* with HUB75_SINGLE_BUFFER)
+**********************************************************/
+#ifndef HUB75_BCM_BITS
+#define HUB75_BCM_BITS 0
+#endif
+
+/**********************************************************
+* HUB75_BCM_BASE
+***********************************************************
+* On-time of the least significant bit-plane in BCM mode,
+* in HUB75 timer ticks of 4 us (prescaler 64).  The most
+* significant plane is lit for BASE << (BITS - 1) ticks,
+* which has to fit in the 8 bit timer.
+*
+* This must be longer than one pass of update() (about
+* 22 us, or 6 ticks) or the ISR will never let go of the
+* CPU while the low planes are being shown.  See the README
+* for the CPU budget at the default of 16 ticks (64 us).
+**********************************************************/
+#ifndef HUB75_BCM_BASE
+#define HUB75_BCM_BASE 16
+#endif
+
+/**********************************************************
+* HUB75_SCANLINE_ISR
+***********************************************************
+* 0 - each call to update() shifts out all HALFROW rows,
+*     which takes 440 us at 16 MHz.  Interrupts are off for
+*     that long when it's called from the HUB75 timer ISR.
+* 1 - each call to update() shifts out and latches just
+*     ONE row, which then stays lit until the next call.
+*     begin() runs the HUB75 timer eight times as fast,
+*     so the refresh rate is the same, but the ISR is only
+*     about 22 us long.
+*
+* BCM mode (HUB75_BCM_BITS) always works one row at a time.
+**********************************************************/
+#ifndef HUB75_SCANLINE_ISR
+#define HUB75_SCANLINE_ISR 0
+#endif
+
+/**********************************************************
+* HUB75_PAGE_FLIP
+***********************************************************
+* 0 - draw() copies the drawing framebuffer to the output
+*     framebuffer with the HUB75 timer interrupt turned
+*     off.
+*     The drawing framebuffer keeps what was drawn.
+* 1 - draw() swaps the two framebuffers instead of copying.
+*     The swap happens at the start of the next frame in
+*     update(), so a frame is never half old and half new
+*     and the ISR is never turned off.  Until flipPending()
+*     returns false, the drawing framebuffer is still being
+*     shown, so don't draw.  Once it returns false, the rows
+*     drawn in the last frame have been copied over, so the
+*     drawing framebuffer is up to date again.
+**********************************************************/
+#ifndef HUB75_PAGE_FLIP
+#define HUB75_PAGE_FLIP 0
+#endif
+
+/**********************************************************
+* HUB75_SINGLE_BUFFER
+***********************************************************
+* 1 - only one framebuffer; update() shifts out the
+*     drawing framebuffer itself, and draw() has nothing
+*     to copy.  Saves a whole framebuffer of RAM (256
+*     bytes for one 8 color 1/8 scan panel, and enough to
+*     fit 16 level BCM on an Uno).
+*
+* Whatever is drawn shows up on the panel's next pass over
+* that row, so a change that spans several rows can show
+* half done for a frame.  To avoid that, change rows just
+* after update() has shifted them out, with waitForRow()
+* and waitForFrame(), and getScanRow().
+*
+* Not with HUB75_PAGE_FLIP or HUB75_LAYERS, which both
+* need the second framebuffer.
+**********************************************************/
+#ifndef HUB75_SINGLE_BUFFER
+#define HUB75_SINGLE_BUFFER 0
+#endif
+
+/**********************************************************
+* HUB75_BITPLANE
+***********************************************************
+* How the framebuffer bytes are laid out.
+*
+* 0 - one byte per column: the top half pixel in bits
+*     2-4 and the bottom half pixel in bits 5-7, ready to
+*     write to PORTD.  256 bytes per framebuffer for one
+*     panel; bits 0 and 1 of every byte are unused.
+* 1 - one bit per pixel per color line, 8 columns to a
+*     byte.  Each buffer row is 6 lines of BUFFCOLS / 8
+*     bytes (R1, G1, B1, R2, G2, B2), so a framebuffer is
+*     192 bytes for one panel.  Fills and 1bpp sprites are
+*     written a byte (8 columns) at a time, but update()
+*     has to put each column back together from 6 bits as
+*     it shifts, which takes about 3 times as long.
+*
+* Not with HUB75_VIRTUAL_COLS, HUB75_NAKED_ISR,
+* HUB75_LAYERS or HUB75_STREAM, which all work on the
+* byte per column layout.
+**********************************************************/
+#ifndef HUB75_BITPLANE
+#define HUB75_BITPLANE 0
+#endif
+
+/**********************************************************
+* HUB75_NAKED_ISR
+***********************************************************
+* 1 - the library defines the HUB75 timer ISR itself, as a
+*     hand written ISR_NAKED routine that only saves the
+*     registers it uses.  It's about 17 us per row instead
+*     of about 22 us for a C ISR calling update().  Do NOT
+*     put an ISR(HUB75_TIMER_VECT) in the sketch, and call
+*     begin(true).
+*
+* Only for the classic 8 color mode, one row per interrupt
+* (HUB75_SCANLINE_ISR), without HUB75_PAGE_FLIP.
+**********************************************************/
+#ifndef HUB75_NAKED_ISR
+#define HUB75_NAKED_ISR 0
+#endif
+
+/**********************************************************
+* HUB75_TRANSFORM
+***********************************************************
+* Coordinate transform done at compile time.  Unlike the
+* translation method passed to begin(), this doesn't cost
+* a function call for every pixel, and filled rectangles
+* and straight lines still get filled a row at a time.
+*
+*   HUB75_XFORM_NONE     - origin at the top left
+*   HUB75_XFORM_ROT90    - turned a quarter clockwise
+*   HUB75_XFORM_ROT180   - upside down; origin bottom right
+*   HUB75_XFORM_ROT270   - turned a quarter counter clockwise
+*   HUB75_XFORM_MIRROR_X - origin top right, X runs left
+*   HUB75_XFORM_MIRROR_Y - origin bottom left, Y runs up
+*                          (same as origin() in the examples)
+*
+* Turned a quarter either way, the panel is 16 wide and 32
+* tall; use WIDTH and HEIGHT instead of COLS and ROWS.  A
+* translation method given to begin() is done first, then
+* this one.
+**********************************************************/
+#define HUB75_XFORM_NONE      0
+#define HUB75_XFORM_ROT90     1
+#define HUB75_XFORM_ROT180    2
+#define HUB75_XFORM_ROT270    3
+#define HUB75_XFORM_MIRROR_X  4
+#define HUB75_XFORM_MIRROR_Y  5
+
+#ifndef HUB75_TRANSFORM
+#define HUB75_TRANSFORM HUB75_XFORM_NONE
+#endif
+
+/**********************************************************
+* HUB75_VIRTUAL_COLS
+***********************************************************
+* 0 - the framebuffers are the size of the panel.
+* Any other number - the framebuffers are this many columns
+*     wide, and the panel shows a window of them picked by
+*     setViewport().  update() reads the buffer from there
+*     on, wrapping around at both edges, so moving the
+*     window scrolls without drawing anything again, or
+*     even calling draw().  The Y offset rolls the rows the
+*     same way.
+*
+* Drawing methods see the whole virtual buffer; WIDTH is
+* HUB75_VIRTUAL_COLS, while COLS is still the size of the
+* panel.  Up to 256 columns, with one row of panels, 1/8 or
+* 1/16 scan, and HUB75_XFORM_NONE or HUB75_XFORM_MIRROR_Y.
+* Each 32 columns is another 256 bytes per framebuffer, so
+* an Uno can have 96 columns (one panel, classic colors).
+**********************************************************/
+#ifndef HUB75_VIRTUAL_COLS
+#define HUB75_VIRTUAL_COLS 0
+#endif
+
+/**********************************************************
+* HUB75_STATS
+***********************************************************
+* 1 - update() and draw() keep counts of frames refreshed,
+*     framebuffers shown, how long update() takes, and how
+*     often it ran late, for getStats().  Costs a few
+*     dozen cycles per update() and 26 bytes of RAM.
+* 0 - none of that is compiled in, and getStats() just
+*     returns zeros.
+*
+* The timing needs the HUB75 timer ISR, and is counted from
+* the timer's compare match, so it includes the time it
+* took the ISR to start.
+**********************************************************/
+#ifndef HUB75_STATS
+#define HUB75_STATS 0
+#endif
+
+/**********************************************************
+* HUB75_LAYERS
+***********************************************************
+* 1 - a background can be set with setBackground(), in RAM
+*     or FLASH.  What's drawn is an overlay on top of it;
+*     pixels of the key color (black unless set) show the
+*     background through, and draw() puts the two together
+*     as it copies the changed rows to the panel.  Static
+*     parts of the picture then don't have to be redrawn
+*     every frame.  Not with HUB75_PAGE_FLIP, which shows
+*     the drawing buffer itself.
+* 0 - what's drawn is what's shown
+**********************************************************/
+#ifndef HUB75_LAYERS
+#define HUB75_LAYERS 0
+#endif
+
+/**********************************************************
+* HUB75_DISPLAY_LIST
+***********************************************************
+* 1 - drawing can be limited to some of the buffer rows
+*     (setClipRows()), which Uno_HUB75_DisplayList uses to
+*     draw again only the rows where something changed.
+*     Costs a test for every pixel drawn.
+* 0 - no row clipping, and no display list
+**********************************************************/
+#ifndef HUB75_DISPLAY_LIST
+#define HUB75_DISPLAY_LIST 0
+#endif
+
+/**********************************************************
+* HUB75_STREAM
+***********************************************************
+* 1 - frames can be sent to the panel over the serial port
+*     instead of drawn by the sketch; see beginStream().
+*     Needs HUB75_PAGE_FLIP.
+* 0 - no streaming
+*
+* The library takes over USART 0 and defines its receive
+* ISR, and so does Serial.  Serial can NOT be used in a
+* sketch with HUB75_STREAM; if it's used anywhere, the
+* link fails with "multiple definition of __vector_18"
+* (__vector_25 on the Mega).
+*
+* HUB75_STREAM_RING is how many bytes can arrive while a
+* finished frame is waiting to be shown; a power of 2, up
+* to 256.  The rest are dropped.
+*
+* HUB75_STREAM_ISR
+* 1 - the library defines the USART receive and transmit
+*     complete ISRs
+* 0 - it doesn't.  The sketch defines them, and calls
+*     streamRx() and streamTx() from them when it's
+*     streaming, e.g. to also use the USART some other way
+*     when it's not.
+**********************************************************/
+#ifndef HUB75_STREAM
+#define HUB75_STREAM 0
+#endif
+
+#ifndef HUB75_STREAM_RING
+#define HUB75_STREAM_RING 128
+#endif
+
+#ifndef HUB75_STREAM_ISR
+#define HUB75_STREAM_ISR 1
+#endif
+
+// sanity checks
+#if HUB75_BCM_BITS == 1 || HUB75_BCM_BITS > 4
+#error HUB75_BCM_BITS must be 0 (classic 8 color) or 2 to 4
+#endif
+
+#if HUB75_BCM_BITS && ((HUB75_BCM_BASE << (HUB75_BCM_BITS - 1)) > 256)
+#error HUB75_BCM_BASE is too long for this many bit-planes
+#endif
+
+#if HUB75_PANEL_COLS % 32 || (HUB75_PANEL_ROWS != 16 && HUB75_PANEL_ROWS != 32)
+#error Panels have to be 16 or 32 rows high, and a multiple of 32 columns wide
+#endif
+
+#if (HUB75_SCAN != 4 && HUB75_SCAN != 8 && HUB75_SCAN != 16) || (HUB75_PANEL_ROWS / 2) % HUB75_SCAN
+#error HUB75_SCAN must be 4, 8 or 16, and no more than half of HUB75_PANEL_ROWS
+#endif
+
+#if HUB75_PANEL_COLS % HUB75_SCAN_BLOCK
+#error HUB75_PANEL_COLS has to be a multiple of HUB75_SCAN_BLOCK
+#endif
+
+#if HUB75_CHAIN % HUB75_CHAIN_ROWS
+#error HUB75_CHAIN has to be a multiple of HUB75_CHAIN_ROWS
+#endif
+
+#if HUB75_NAKED_ISR && (!HUB75_SCANLINE_ISR || HUB75_BCM_BITS || HUB75_PAGE_FLIP || HUB75_VIRTUAL_COLS || HUB75_STATS)
+#error HUB75_NAKED_ISR needs HUB75_SCANLINE_ISR, and cannot be used with HUB75_BCM_BITS, HUB75_PAGE_FLIP, HUB75_VIRTUAL_COLS or HUB75_STATS
+#endif
+
+#if HUB75_VIRTUAL_COLS && (HUB75_VIRTUAL_COLS > 256 || HUB75_VIRTUAL_COLS < HUB75_PANEL_COLS * HUB75_CHAIN)
+#error HUB75_VIRTUAL_COLS has to be at least as wide as the panels, and no more than 256
+#endif
+
+#if HUB75_VIRTUAL_COLS && (HUB75_CHAIN_ROWS > 1 || HUB75_SCAN * 2 != HUB75_PANEL_ROWS)
+#error HUB75_VIRTUAL_COLS needs one row of panels, with 1/8 or 1/16 scan
+#endif
+
+#if HUB75_VIRTUAL_COLS && HUB75_TRANSFORM != HUB75_XFORM_NONE && HUB75_TRANSFORM != HUB75_XFORM_MIRROR_Y
+#error HUB75_VIRTUAL_COLS only works with HUB75_XFORM_NONE or HUB75_XFORM_MIRROR_Y
+#endif
+
+#if HUB75_STREAM && !HUB75_PAGE_FLIP
+#error HUB75_STREAM needs HUB75_PAGE_FLIP
+#endif
+
+#if HUB75_STREAM && (HUB75_STREAM_RING > 256 || (HUB75_STREAM_RING & (HUB75_STREAM_RING - 1)))
+#error HUB75_STREAM_RING has to be a power of 2, no more than 256
+#endif
+
+#if HUB75_LAYERS && HUB75_PAGE_FLIP
+#error HUB75_LAYERS cannot be used with HUB75_PAGE_FLIP
+#endif
+
+#if HUB75_SINGLE_BUFFER && (HUB75_PAGE_FLIP || HUB75_LAYERS)
+#error HUB75_SINGLE_BUFFER cannot be used with HUB75_PAGE_FLIP or HUB75_LAYERS
+#endif
+
+#if HUB75_BITPLANE && (HUB75_VIRTUAL_COLS || HUB75_NAKED_ISR || HUB75_LAYERS || HUB75_STREAM)
+#error HUB75_BITPLANE cannot be used with HUB75_VIRTUAL_COLS, HUB75_NAKED_ISR, HUB75_LAYERS or HUB75_STREAM
+#endif
+
+#endif // PANEL_CONFIG_H_
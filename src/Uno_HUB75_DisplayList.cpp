@@ -0,0 +1,641 @@
+/**********************************************************
+ * @file    Uno_HUB75_DisplayList.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Methods for the Uno_HUB75_DisplayList class.
+ *
+ * Each item keeps the mask of buffer rows it's drawn in.
+ * A change adds the item's rows from before and after to
+ * the pending mask, and refresh() clears those rows and
+ * draws the items that touch them with the panel clipped
+ * to them (setClipRows()).  Pixels in other rows are left
+ * alone, so items that reach outside the changed rows
+ * don't need to be drawn in full, and the order of
+ * overlapping items is kept.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+
+#if HUB75_DISPLAY_LIST
+
+#include "Uno_HUB75_DisplayList.h"
+#include "Arduino.h"
+
+// op codes; the low nibble of an item's first byte
+#define ITEM_LINE     1
+#define ITEM_RECT     2
+#define ITEM_BOX      3
+#define ITEM_TEXT     4
+#define ITEM_TEXT_P   5
+#define ITEM_SPRITE   6
+#define ITEM_OPS      0x0f
+
+// flags in the high nibble
+#define ITEM_HIDDEN   0x80
+
+// bytes of an Item up to the operands
+#define ITEM_HEAD     offsetof(Item, u)
+
+/********************************************************
+* opSize()
+*********************************************************
+* Bytes an item takes in the list
+*
+* Parameters:
+*   uint8_t op - the item's first byte
+* Returns
+*   uint8_t - its size
+********************************************************/
+uint8_t Uno_HUB75_DisplayList::opSize(uint8_t op)
+{
+  switch (op & ITEM_OPS)
+  {
+    case ITEM_TEXT:
+    case ITEM_TEXT_P:
+      return (ITEM_HEAD + sizeof(((Item*)0)->u.ref));
+
+    case ITEM_SPRITE:
+      return (ITEM_HEAD + sizeof(((Item*)0)->u.sprite));
+
+    default:
+      return (ITEM_HEAD + sizeof(((Item*)0)->u.corner));
+  }
+}
+
+/********************************************************
+* load() / store()
+*********************************************************
+* Copy an item out of the list and back in
+*
+* Parameters:
+*   Handle h - where it is
+*   Item& item - the item
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::load(Uno_HUB75_DisplayList::Handle h, Uno_HUB75_DisplayList::Item& item)
+{
+  memset(&item, 0, sizeof(item));
+  memcpy(&item, list + h, opSize(list[h]));
+}
+
+void Uno_HUB75_DisplayList::store(Uno_HUB75_DisplayList::Handle h, Uno_HUB75_DisplayList::Item& item)
+{
+  memcpy(list + h, &item, opSize(item.op));
+}
+
+/********************************************************
+* itemRows()
+*********************************************************
+* Work out the buffer rows an item is drawn in, from its
+* bounding box.  Text and sprites are drawn from their
+* top row at Y toward lower Y
+*
+* Parameters:
+*   Item& item - the item
+* Returns
+*   Uno_HUB75_Driver::RowMask - its rows; none if hidden
+********************************************************/
+Uno_HUB75_Driver::RowMask Uno_HUB75_DisplayList::itemRows(Uno_HUB75_DisplayList::Item& item)
+{
+  if (item.op & ITEM_HIDDEN)
+  {
+    return (0);
+  }
+
+  uint8_t op = item.op & ITEM_OPS;
+
+  if (op == ITEM_TEXT || op == ITEM_TEXT_P)
+  {
+    Uno_HUB75_Driver::Font f;
+    memcpy_P(&f, item.u.ref.font, sizeof(f));
+
+    const Uno_HUB75_Driver::Font* was = panel.getFont();
+    panel.setFont((const Uno_HUB75_Driver::Font*)item.u.ref.font);
+
+    int16_t width = (op == ITEM_TEXT) ?
+                      panel.textWidth((const char*)item.u.ref.data) :
+                      panel.textWidth_P((PGM_P)item.u.ref.data);
+
+    panel.setFont(was);
+
+    if (!width)
+    {
+      return (0);
+    }
+
+    return (panel.rectRows(item.x, item.y - f.height + 1, item.x + width - 1, item.y));
+  }
+
+  if (op == ITEM_SPRITE)
+  {
+    Uno_HUB75_Driver::Sprite s;
+    memcpy_P(&s, item.u.sprite.data, sizeof(s));
+
+    if (!s.width || !s.height)
+    {
+      return (0);
+    }
+
+    return (panel.rectRows(item.x, item.y - s.height + 1, item.x + s.width - 1, item.y));
+  }
+
+  return (panel.rectRows(item.x, item.y, item.u.corner.x2, item.u.corner.y2));
+}
+
+/********************************************************
+* drawItem()
+*********************************************************
+* Draw one item on the panel
+*
+* Parameters:
+*   Item& item - the item
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::drawItem(Uno_HUB75_DisplayList::Item& item)
+{
+  Uno_HUB75_Driver::Colors c = (Uno_HUB75_Driver::Colors)item.color;
+
+  switch (item.op & ITEM_OPS)
+  {
+    case ITEM_LINE:
+      panel.line(item.x, item.y, item.u.corner.x2, item.u.corner.y2, c);
+      break;
+
+    case ITEM_RECT:
+    case ITEM_BOX:
+      panel.rectangle(item.x, item.y, item.u.corner.x2, item.u.corner.y2, c, (item.op & ITEM_OPS) == ITEM_BOX);
+      break;
+
+    case ITEM_TEXT:
+    case ITEM_TEXT_P:
+    {
+      const Uno_HUB75_Driver::Font* was = panel.getFont();
+      panel.setFont((const Uno_HUB75_Driver::Font*)item.u.ref.font);
+
+      if ((item.op & ITEM_OPS) == ITEM_TEXT)
+      {
+        panel.drawText(item.x, item.y, (const char*)item.u.ref.data, c);
+      }
+      else
+      {
+        panel.drawText_P(item.x, item.y, (PGM_P)item.u.ref.data, c);
+      }
+
+      panel.setFont(was);
+      break;
+    }
+
+    case ITEM_SPRITE:
+      panel.drawSprite(item.x, item.y, (const Uno_HUB75_Driver::Sprite*)item.u.sprite.data, item.u.sprite.frame, c);
+      break;
+  }
+}
+
+/********************************************************
+* add()
+*********************************************************
+* Put a new item at the end of the list
+*
+* Parameters:
+*   Item& item - the item; its rows are filled in
+* Returns
+*   Handle - where it went, or NONE if it didn't fit
+********************************************************/
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::add(Uno_HUB75_DisplayList::Item& item)
+{
+  uint8_t size = opSize(item.op);
+
+  if (used + size > listSize)
+  {
+    return (NONE);
+  }
+
+  Uno_HUB75_DisplayList::Handle h = used;
+  used += size;
+
+  item.rows = this->itemRows(item);
+  pending |= item.rows;
+  this->store(h, item);
+
+  return (h);
+}
+
+/********************************************************
+* update()
+*********************************************************
+* Store an item that was changed, marking the rows it was
+* in and the rows it's in now
+*
+* Parameters:
+*   Handle h - where it is
+*   Item& item - the item, with its rows from before
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::update(Uno_HUB75_DisplayList::Handle h, Uno_HUB75_DisplayList::Item& item)
+{
+  pending |= item.rows;
+  item.rows = this->itemRows(item);
+  pending |= item.rows;
+
+  this->store(h, item);
+}
+
+/********************************************************
+* addLine()
+*********************************************************
+* Add a line, as drawn by line()
+*
+* Parameters:
+*   int16_t x1, y1 - one end
+*   int16_t x2, y2 - the other end
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   Handle - the item, or NONE if the list is full
+********************************************************/
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::addLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors c)
+{
+  Item item;
+  item.op = ITEM_LINE;
+  item.color = c;
+  item.x = x1;
+  item.y = y1;
+  item.u.corner.x2 = x2;
+  item.u.corner.y2 = y2;
+
+  return (this->add(item));
+}
+
+/********************************************************
+* addRect()
+*********************************************************
+* Add a rectangle, as drawn by rectangle()
+*
+* Parameters:
+*   int16_t x1, y1 - one corner
+*   int16_t x2, y2 - the opposite corner
+*   Uno_HUB75_Driver::Colors c - the color
+*   bool fill - true for a filled box, false for an outline
+* Returns
+*   Handle - the item, or NONE if the list is full
+********************************************************/
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::addRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors c, bool fill)
+{
+  Item item;
+  item.op = fill ? ITEM_BOX : ITEM_RECT;
+  item.color = c;
+  item.x = x1;
+  item.y = y1;
+  item.u.corner.x2 = x2;
+  item.u.corner.y2 = y2;
+
+  return (this->add(item));
+}
+
+/********************************************************
+* addText()
+*********************************************************
+* Add a string, drawn by drawText() in the current font.
+* The string isn't copied
+*
+* Parameters:
+*   int16_t x - X coordinate of the left edge
+*   int16_t y - Y coordinate of the top row
+*   const char* str - the string, in RAM, or F("...")
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   Handle - the item, or NONE if the list is full
+********************************************************/
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::addText(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c)
+{
+  Item item;
+  item.op = ITEM_TEXT;
+  item.color = c;
+  item.x = x;
+  item.y = y;
+  item.u.ref.data = str;
+  item.u.ref.font = panel.getFont();
+
+  return (this->add(item));
+}
+
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::addText(int16_t x, int16_t y, const __FlashStringHelper* str, Uno_HUB75_Driver::Colors c)
+{
+  Item item;
+  item.op = ITEM_TEXT_P;
+  item.color = c;
+  item.x = x;
+  item.y = y;
+  item.u.ref.data = str;
+  item.u.ref.font = panel.getFont();
+
+  return (this->add(item));
+}
+
+/********************************************************
+* addSprite()
+*********************************************************
+* Add a sprite, as drawn by drawSprite()
+*
+* Parameters:
+*   int16_t x - X coordinate of the left column
+*   int16_t y - Y coordinate of the top row
+*   const Uno_HUB75_Driver::Sprite* sprite - in PROGMEM
+*   uint8_t frame - which frame
+*   Uno_HUB75_Driver::Colors c - color of a 1bpp sprite
+* Returns
+*   Handle - the item, or NONE if the list is full
+********************************************************/
+Uno_HUB75_DisplayList::Handle Uno_HUB75_DisplayList::addSprite(int16_t x, int16_t y, const Uno_HUB75_Driver::Sprite* sprite, uint8_t frame, Uno_HUB75_Driver::Colors c)
+{
+  Item item;
+  item.op = ITEM_SPRITE;
+  item.color = c;
+  item.x = x;
+  item.y = y;
+  item.u.sprite.data = sprite;
+  item.u.sprite.frame = frame;
+
+  return (this->add(item));
+}
+
+/********************************************************
+* moveTo()
+*********************************************************
+* Move an item so its first corner (the start of a line,
+* the top left of text or a sprite) is at X/Y
+*
+* Parameters:
+*   Handle h - the item
+*   int16_t x - new X coordinate
+*   int16_t y - new Y coordinate
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::moveTo(Uno_HUB75_DisplayList::Handle h, int16_t x, int16_t y)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  if (x == item.x && y == item.y)
+  {
+    return;
+  }
+
+  uint8_t op = item.op & ITEM_OPS;
+
+  if (op == ITEM_LINE || op == ITEM_RECT || op == ITEM_BOX)
+  {
+    item.u.corner.x2 += x - item.x;
+    item.u.corner.y2 += y - item.y;
+  }
+
+  item.x = x;
+  item.y = y;
+
+  this->update(h, item);
+}
+
+/********************************************************
+* setColor()
+*********************************************************
+* Change the color of an item
+*
+* Parameters:
+*   Handle h - the item
+*   Uno_HUB75_Driver::Colors c - the new color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::setColor(Uno_HUB75_DisplayList::Handle h, Uno_HUB75_Driver::Colors c)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  if (item.color == c)
+  {
+    return;
+  }
+
+  item.color = c;
+  this->update(h, item);
+}
+
+/********************************************************
+* setText()
+*********************************************************
+* Point a text item at another string
+*
+* Parameters:
+*   Handle h - the item
+*   const char* str - the string, in RAM, or F("...")
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::setText(Uno_HUB75_DisplayList::Handle h, const char* str)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  uint8_t op = item.op & ITEM_OPS;
+
+  if (op == ITEM_TEXT || op == ITEM_TEXT_P)
+  {
+    item.op = (item.op & ~ITEM_OPS) | ITEM_TEXT;
+    item.u.ref.data = str;
+    this->update(h, item);
+  }
+}
+
+void Uno_HUB75_DisplayList::setText(Uno_HUB75_DisplayList::Handle h, const __FlashStringHelper* str)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  uint8_t op = item.op & ITEM_OPS;
+
+  if (op == ITEM_TEXT || op == ITEM_TEXT_P)
+  {
+    item.op = (item.op & ~ITEM_OPS) | ITEM_TEXT_P;
+    item.u.ref.data = str;
+    this->update(h, item);
+  }
+}
+
+/********************************************************
+* setFrame()
+*********************************************************
+* Show another frame of a sprite item
+*
+* Parameters:
+*   Handle h - the item
+*   uint8_t frame - the frame
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::setFrame(Uno_HUB75_DisplayList::Handle h, uint8_t frame)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  if ((item.op & ITEM_OPS) == ITEM_SPRITE && item.u.sprite.frame != frame)
+  {
+    item.u.sprite.frame = frame;
+    this->update(h, item);
+  }
+}
+
+/********************************************************
+* show()
+*********************************************************
+* Hide an item, or show it again.  A hidden item keeps
+* its place in the list
+*
+* Parameters:
+*   Handle h - the item
+*   bool visible - false to hide it
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::show(Uno_HUB75_DisplayList::Handle h, bool visible)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+
+  if (!(item.op & ITEM_HIDDEN) == visible)
+  {
+    return;
+  }
+
+  item.op ^= ITEM_HIDDEN;
+  this->update(h, item);
+}
+
+/********************************************************
+* changed()
+*********************************************************
+* Mark an item to be drawn again, after changing it some
+* way the list can't see (the string it points to)
+*
+* Parameters:
+*   Handle h - the item
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_DisplayList::changed(Uno_HUB75_DisplayList::Handle h)
+{
+  if (h >= used)
+  {
+    return;
+  }
+
+  Item item;
+  this->load(h, item);
+  this->update(h, item);
+}
+
+/********************************************************
+* clear()
+*********************************************************
+* Take every item off the list.  Their rows are cleared
+* at the next refresh(), and old handles are no good
+********************************************************/
+void Uno_HUB75_DisplayList::clear()
+{
+  Item item;
+
+  for (Uno_HUB75_DisplayList::Handle h = 0; h < used; h += opSize(list[h]))
+  {
+    this->load(h, item);
+    pending |= item.rows;
+  }
+
+  used = 0;
+}
+
+/********************************************************
+* refresh()
+*********************************************************
+* Clear the rows where something changed, draw every
+* item that touches them (only in those rows), and draw()
+* the panel.  With nothing changed, that's only the
+* draw(), which has nothing to do.
+*
+* With HUB75_PAGE_FLIP, nothing is drawn while a flip is
+* pending; the changes wait for the next call
+*
+* Returns
+*   Uno_HUB75_Driver::RowMask - the rows drawn again
+********************************************************/
+Uno_HUB75_Driver::RowMask Uno_HUB75_DisplayList::refresh()
+{
+#if HUB75_PAGE_FLIP
+  if (panel.flipPending())
+  {
+    return (0);
+  }
+#endif
+
+  Uno_HUB75_Driver::RowMask rows = pending;
+
+  if (rows)
+  {
+    pending = 0;
+
+    Uno_HUB75_Driver::RowMask clip = panel.getClipRows();
+    panel.clearRows(rows);
+    panel.setClipRows(rows);
+
+    Item item;
+
+    for (Uno_HUB75_DisplayList::Handle h = 0; h < used; h += opSize(item.op))
+    {
+      this->load(h, item);
+
+      if (item.rows & rows)
+      {
+        this->drawItem(item);
+      }
+    }
+
+    panel.setClipRows(clip);
+  }
+
+  panel.draw();
+
+  return (rows);
+}
+
+#endif // HUB75_DISPLAY_LIST
@@ -0,0 +1,126 @@
+/**********************************************************
+ * @file    Uno_HUB75_DisplayList.h
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * A retained display list for Uno_HUB75_Driver
+ * (HUB75_DISPLAY_LIST).
+ *
+ * Instead of drawing every line, box and string again for
+ * every frame, the sketch adds them to the list once, and
+ * gets back a handle for each.  Changing an item through
+ * its handle (moving it, or changing its color, text or
+ * frame) only marks the buffer rows it was and is in.
+ * refresh() then clears just those rows and draws every
+ * item that touches them, clipped to them, so a frame
+ * where nothing changed costs next to nothing.
+ *
+ * The items are kept in a buffer the sketch hands over, as
+ * a string of commands: an op code and its operands, 10
+ * to 12 bytes an item.  A handle is where the item starts
+ * in the buffer.
+**********************************************************/
+#ifndef UNO_HUB75_DISPLAYLIST_H_
+#define UNO_HUB75_DISPLAYLIST_H_
+
+#include "Uno_HUB75_Driver.h"
+
+#if !HUB75_DISPLAY_LIST
+#error Uno_HUB75_DisplayList needs HUB75_DISPLAY_LIST
+#endif
+
+class Uno_HUB75_DisplayList
+{
+public:
+  // where an item is in the list; stays the same as long as the
+  // list isn't cleared
+  typedef uint16_t Handle;
+
+  // returned when the list is full
+  static const Handle NONE = 0xffff;
+
+  // 'buff' holds the items; 'size' bytes of it
+  Uno_HUB75_DisplayList(Uno_HUB75_Driver& p, uint8_t* buff, uint16_t size) :
+        panel(p), list(buff), listSize(size), used(0), pending(0) {}
+  ~Uno_HUB75_DisplayList() {}
+
+  // add items; they're drawn in the order they're added, so later
+  // ones cover earlier ones.  Text is drawn in the font that was
+  // set when it was added.  Strings aren't copied, so keep them
+  // around; call changed() after changing one in place
+  Handle addLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors c);
+  Handle addRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors c, bool fill = false);
+  Handle addText(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c);
+  Handle addText(int16_t x, int16_t y, const __FlashStringHelper* str, Uno_HUB75_Driver::Colors c);
+  Handle addSprite(int16_t x, int16_t y, const Uno_HUB75_Driver::Sprite* sprite, uint8_t frame = 0, Uno_HUB75_Driver::Colors c = Uno_HUB75_Driver::WHITE);
+
+  // change an item.  moveTo() moves its first corner (or top left
+  // of text and sprites) to X/Y, and the rest with it
+  void moveTo(Handle h, int16_t x, int16_t y);
+  void setColor(Handle h, Uno_HUB75_Driver::Colors c);
+  void setText(Handle h, const char* str);
+  void setText(Handle h, const __FlashStringHelper* str);
+  void setFrame(Handle h, uint8_t frame);
+  void show(Handle h, bool visible);
+
+  // the item looks different some other way (its string changed)
+  void changed(Handle h);
+
+  // take everything off the list
+  void clear();
+
+  // draw the rows that changed, then call the panel's draw().
+  // Returns the rows that were drawn again
+  Uno_HUB75_Driver::RowMask refresh();
+
+  // rows that the next refresh() will draw again
+  Uno_HUB75_Driver::RowMask getPendingRows() { return (pending); }
+
+private:
+  // an item as it's used; only the first opSize() bytes of it are
+  // kept in the list
+  typedef struct
+  {
+    uint8_t op;                       // ITEM_... and flags
+    uint8_t color;                    // Colors value
+    Uno_HUB75_Driver::RowMask rows;   // buffer rows it's drawn in
+    int16_t x;
+    int16_t y;
+    union
+    {
+      struct
+      {
+        int16_t x2;                   // opposite corner
+        int16_t y2;
+      } corner;
+      struct
+      {
+        const void* data;             // string or sprite
+        const void* font;             // text: the font
+      } ref;
+      struct
+      {
+        const void* data;             // sprite
+        uint8_t frame;
+      } sprite;
+    } u;
+  } Item;
+
+  Handle add(Item& item);
+  void load(Handle h, Item& item);
+  void store(Handle h, Item& item);
+  void update(Handle h, Item& item);
+  void drawItem(Item& item);
+  Uno_HUB75_Driver::RowMask itemRows(Item& item);
+  static uint8_t opSize(uint8_t op);
+
+  Uno_HUB75_Driver& panel;
+  uint8_t* list;
+  uint16_t listSize;
+  uint16_t used;
+
+  // rows to draw at the next refresh()
+  Uno_HUB75_Driver::RowMask pending;
+};
+
+#endif // UNO_HUB75_DISPLAYLIST_H_
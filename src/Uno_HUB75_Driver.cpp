@@ -12,13 +12,12 @@
  * 
  * This library displays 3-bit colors (8 colors) using a
  * double buffered framebuffer to prevent flickering.  
- * Ideally, it will be using hardware timer 2 for updates,
+ * Ideally, it will be using hardware timer 2 (3 on a 32U4) for updates,
  * but can optionally be updated in the caller's main
  * loop.
 **********************************************************/
 #include "Uno_HUB75_Driver.h"
 #include "Uno_HUB75_Driver_impl.h"
-#include "font.h"
 
 #include "Arduino.h"
 
@@ -27,6 +26,41 @@
 
 #define swap(a, b)  {int16_t t = a; a = b; b = t;}
 
+#if !HUB75_LINEAR
+/********************************************************
+* hub75ScanMap()
+*********************************************************
+* The built-in pixel order for 1/4 scan panels.  Each row
+* address drives SCANFOLD rows in each half of the panel,
+* and their shift registers are chained in blocks of
+* HUB75_SCAN_BLOCK columns: a block of the last of those
+* rows, then the same block of the one before it, and so
+* on, then the next block.  This is the order most of the
+* 32 X 16 outdoor panels use, with blocks of 8.
+*
+* It's weak, so if a panel is wired some other way a sketch
+* can define its own hub75ScanMap() to replace it.  It's
+* only called when drawing, never by update()
+*
+* Parameters:
+*   int16_t& x - column in the panel, 0 to HUB75_PANEL_COLS - 1;
+*     changed to the place in the shift registers
+*   int16_t& y - row in the half of the panel, 0 to HALFROW - 1;
+*     changed to the row address
+* Returns
+*   void
+********************************************************/
+void __attribute__((weak)) hub75ScanMap(int16_t& x, int16_t& y)
+{
+  int16_t block = x / HUB75_SCAN_BLOCK;
+  int16_t group = y / SCANROWS;
+
+  x = (block * SCANFOLD + (SCANFOLD - 1 - group)) * HUB75_SCAN_BLOCK + 
+      x - block * HUB75_SCAN_BLOCK;
+  y -= group * SCANROWS;
+}
+#endif
+
 /********************************************************
 * clear()
 *********************************************************
@@ -51,9 +85,128 @@ void Uno_HUB75_Driver::clear()
 ********************************************************/
 void Uno_HUB75_Driver::fillAll(Uno_HUB75_Driver::Colors c)
 {
-  uint8_t val = (uint8_t)c << 2 | (uint8_t)c << 5;
-  memset(pixBuff, val, HALFROW * COLS);
+  // same color in every bit-plane
+  Uno_HUB75_Driver::Pixel pix = toPixel(c);
+
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    this->fillPlane(plane, (pix >> (plane * 3)) & 0x07);
+  }
+
+  dirtyRows = ALLROWS;
+}
+
+#if HUB75_BCM_BITS
+/********************************************************
+* fillAll()
+*********************************************************
+* BCM only.  Make the whole display one solid color given
+* as brightness levels of 0 to MAXLEVEL per channel
+*
+* Parameters:
+*   uint8_t r - red level
+*   uint8_t g - green level
+*   uint8_t b - blue level
+* Returns
+*   Void
+********************************************************/
+void Uno_HUB75_Driver::fillAll(uint8_t r, uint8_t g, uint8_t b)
+{
+  Uno_HUB75_Driver::Pixel pix = toPixel(r, g, b);
+
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    this->fillPlane(plane, (pix >> (plane * 3)) & 0x07);
+  }
+
+  dirtyRows = ALLROWS;
+}
+#endif
+
+/********************************************************
+* fillPlane()
+*********************************************************
+* Set every pixel of one bit-plane of the drawing buffer
+* to the same 3 bit color code, with memset()s
+*
+* Parameters:
+*   uint8_t plane - bit-plane, 0 in classic mode
+*   uint8_t code - red, green and blue bits, red lowest
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::fillPlane(uint8_t plane, uint8_t code)
+{
+#if HUB75_BITPLANE
+  // each color line is all set or all clear
+  for (uint8_t row = 0; row < SCANROWS; ++row)
+  {
+    uint8_t* line = pixBuff[plane * SCANROWS + row];
+
+    for (uint8_t ii = 0; ii < 6; ++ii, line += LINEBYTES)
+    {
+      memset(line, (code & bit(ii % 3)) ? 0xff : 0x00, LINEBYTES);
+    }
+  }
+#else
+  memset(pixBuff[plane * SCANROWS], code << 2 | code << 5, SCANROWS * BUFFCOLS);
+#endif
+}
+
+/********************************************************
+* toPixel()
+*********************************************************
+* Convert a member of the Colors enum to the value the
+* framebuffer stores.  In BCM mode that is the same 3 bit
+* color in every bit-plane, which is full brightness
+*
+* Parameters:
+*   Uno_HUB75_Driver::Colors color - color to convert
+* Returns
+*   Uno_HUB75_Driver::Pixel - framebuffer value
+********************************************************/
+Uno_HUB75_Driver::Pixel Uno_HUB75_Driver::toPixel(Uno_HUB75_Driver::Colors c)
+{
+  Uno_HUB75_Driver::Pixel pix = 0;
+
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    pix |= (Uno_HUB75_Driver::Pixel)c << (plane * 3);
+  }
+
+  return (pix);
+}
+
+#if HUB75_BCM_BITS
+/********************************************************
+* toPixel()
+*********************************************************
+* BCM only.  Convert brightness levels to the value the
+* framebuffer stores.  Bit 'n' of each level goes into
+* bit-plane 'n'
+*
+* Parameters:
+*   uint8_t r - red level, 0 to MAXLEVEL
+*   uint8_t g - green level, 0 to MAXLEVEL
+*   uint8_t b - blue level, 0 to MAXLEVEL
+* Returns
+*   Uno_HUB75_Driver::Pixel - framebuffer value
+********************************************************/
+Uno_HUB75_Driver::Pixel Uno_HUB75_Driver::toPixel(uint8_t r, uint8_t g, uint8_t b)
+{
+  Uno_HUB75_Driver::Pixel pix = 0;
+
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    uint8_t code = ((r >> plane) & 0x01) | 
+                   ((g >> plane) & 0x01) << 1 | 
+                   ((b >> plane) & 0x01) << 2;
+    pix |= (Uno_HUB75_Driver::Pixel)code << (plane * 3);
+  }
+
+  return (pix);
 }
+#endif
 
 /********************************************************
 * setPixel()
@@ -70,11 +223,36 @@ void Uno_HUB75_Driver::fillAll(Uno_HUB75_Driver::Colors c)
 void Uno_HUB75_Driver::setPixel(int16_t x, int16_t y, Uno_HUB75_Driver::Colors color)
 {
   // only set buffer if in the actual drawable region
-  if (x >= 0 && x < COLS && y >= 0 && y < ROWS)
+  if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
+  {
+    this->setBuff(x, y, toPixel(color));
+  }
+}
+
+#if HUB75_BCM_BITS
+/********************************************************
+* setPixel()
+*********************************************************
+* BCM only.  Set a single pixel on the panel to a color
+* given as brightness levels of 0 to MAXLEVEL per channel
+*
+* Parameters:
+*   int16_t x - the x coordinate
+*   int16_t y - the y coordinate
+*   uint8_t r - red level
+*   uint8_t g - green level
+*   uint8_t b - blue level
+* Returns
+*   Void
+********************************************************/
+void Uno_HUB75_Driver::setPixel(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b)
+{
+  if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
   {
-    this->setBuff(x, y, color);
+    this->setBuff(x, y, toPixel(r, g, b));
   }
 }
+#endif
 
 /********************************************************
 * getPixel()
@@ -85,11 +263,12 @@ void Uno_HUB75_Driver::setPixel(int16_t x, int16_t y, Uno_HUB75_Driver::Colors c
 *   int16_t x - the x coordinate
 *   int16_t y - the y coordinate
 * Returns
-*   Uno_HUB75_Driver::Colors color - color of the specified pixel
+*   Uno_HUB75_Driver::Colors color - color of the specified pixel.
+*     In BCM mode, this is the most significant bit-plane
 ********************************************************/
 Uno_HUB75_Driver::Colors Uno_HUB75_Driver::getPixel(int16_t x, int16_t y)
 {
-  if (x >= 0 && x < COLS && y >= 0 && y < ROWS)
+  if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
   {
     // handle coordinate translation
     if (xlatFunc)
@@ -97,16 +276,28 @@ Uno_HUB75_Driver::Colors Uno_HUB75_Driver::getPixel(int16_t x, int16_t y)
       this->xlatFunc(x, y);
     }
 
-    if (y < HALFROW)
+#if HUB75_BITPLANE
+    // most significant bit-plane (the only one in classic mode)
+    return ((Uno_HUB75_Driver::Colors)(this->getBuff(x, y) >> ((PLANES - 1) * 3)));
+#else
+    xform(x, y);
+    chainMap(x, y);
+    scanMap(x, y);
+
+    // most significant bit-plane (the only one in classic mode)
+    uint8_t* plane = pixBuff[(PLANES - 1) * SCANROWS];
+
+    if (y < SCANROWS)
     {
       // pixel is in the top half, so shift right 2 bits and mask off the lower 3
-      return ((Uno_HUB75_Driver::Colors)((pixBuff[y][x] >> 2) & 0x03));
+      return ((Uno_HUB75_Driver::Colors)((plane[y * BUFFCOLS + x] >> 2) & 0x07));
     }
     else
     {
       // pixil is in the lower half; shift right 5 bits and mask off the lower 3
-      return ((Uno_HUB75_Driver::Colors)((pixBuff[y][x] >> 5) & 0x03));
+      return ((Uno_HUB75_Driver::Colors)((plane[(y - SCANROWS) * BUFFCOLS + x] >> 5) & 0x07));
     }
+#endif
   }
   
   return (Uno_HUB75_Driver::BLACK);
@@ -115,7 +306,9 @@ Uno_HUB75_Driver::Colors Uno_HUB75_Driver::getPixel(int16_t x, int16_t y)
 /********************************************************
 * copyPixel()
 *********************************************************
-* Set a single pixel on the panel
+* Copy a single pixel on the panel.  A source pixel off
+* the panel is black.  In BCM mode every bit-plane is
+* copied, so the color keeps its brightness levels
 *
 * Parameters:
 *   int16_t x1 - the x coordinate of source pixel
@@ -127,13 +320,27 @@ Uno_HUB75_Driver::Colors Uno_HUB75_Driver::getPixel(int16_t x, int16_t y)
 ********************************************************/
 void Uno_HUB75_Driver::copyPixel(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
 {
-  this->setPixel(x2, y2, this->getPixel(x1, y2));
+  Uno_HUB75_Driver::Pixel c = 0;
+
+  if (x1 >= 0 && x1 < WIDTH && y1 >= 0 && y1 < HEIGHT)
+  {
+    if (xlatFunc)
+    {
+      this->xlatFunc(x1, y1);
+    }
+
+    c = this->getBuff(x1, y1);
+  }
+
+  this->setBuff(x2, y2, c);
 }
 
 /********************************************************
 * copyRegion()
 *********************************************************
-* Copy the colors of a rectangle to another rectangle
+* Copy the colors of a rectangle to another rectangle.
+* The size is taken from 'dst', starting at the top left
+* of 'src'.  The rectangles may overlap; see moveRegion()
 *
 * Parameters:
 *   Uno_HUB75_Driver::Rect src - reference to source region
@@ -143,11 +350,267 @@ void Uno_HUB75_Driver::copyPixel(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
 ********************************************************/
 void Uno_HUB75_Driver::copyRegion(Uno_HUB75_Driver::Rect& src, Uno_HUB75_Driver::Rect& dst)
 {
-  for(int16_t hgt = 0; hgt <= (dst.y2 - dst.y1); ++hgt)
+  this->moveRegion(src.x1, src.y1, dst.x1, dst.y1, dst.x2 - dst.x1 + 1, dst.y2 - dst.y1 + 1);
+}
+
+/********************************************************
+* scrollRegion()
+*********************************************************
+* Move what's in a rectangle by 'dx' columns and 'dy'
+* rows, staying inside the rectangle.  What moves past
+* its edges is lost, and what it uncovers is filled with
+* a color.  Positive 'dx' and 'dy' move toward higher X
+* and Y
+*
+* Parameters:
+*   Uno_HUB75_Driver::Rect r - reference to the region
+*   int16_t dx - columns to move by
+*   int16_t dy - rows to move by
+*   Uno_HUB75_Driver::Colors fill - color for what's uncovered
+* Returns
+*   Void
+********************************************************/
+void Uno_HUB75_Driver::scrollRegion(Uno_HUB75_Driver::Rect& r, int16_t dx, int16_t dy, Uno_HUB75_Driver::Colors fill)
+{
+  int16_t x1 = r.x1;
+  int16_t y1 = r.y1;
+  int16_t x2 = r.x2;
+  int16_t y2 = r.y2;
+
+  // fixup backwards dimensions, and clip to the panel
+  if (x1 > x2)     swap(x1, x2)
+  if (y1 > y2)     swap(y1, y2)
+
+  if (x1 < 0)      x1 = 0;
+  if (y1 < 0)      y1 = 0;
+  if (x2 > MAXX)   x2 = MAXX;
+  if (y2 > MAXY)   y2 = MAXY;
+
+  if (x1 > x2 || y1 > y2)
+  {
+    return;
+  }
+
+  int16_t w = x2 - x1 + 1;
+  int16_t h = y2 - y1 + 1;
+  Uno_HUB75_Driver::Pixel pix = toPixel(fill);
+
+  // moved all the way out
+  if (abs(dx) >= w || abs(dy) >= h)
+  {
+    this->spanFill(x1, y1, x2, y2, pix);
+    return;
+  }
+
+  // the part that stays in the rectangle
+  this->moveRegion(x1 + max(-dx, 0), y1 + max(-dy, 0),
+                   x1 + max(dx, 0), y1 + max(dy, 0),
+                   w - abs(dx), h - abs(dy));
+
+  // and the strips it uncovered
+  if (dx > 0)         this->spanFill(x1, y1, x1 + dx - 1, y2, pix);
+  else if (dx < 0)    this->spanFill(x2 + dx + 1, y1, x2, y2, pix);
+
+  if (dy > 0)         this->spanFill(x1, y1, x2, y1 + dy - 1, pix);
+  else if (dy < 0)    this->spanFill(x1, y2 + dy + 1, x2, y2, pix);
+}
+
+/********************************************************
+* moveRegion()
+*********************************************************
+* Copy a 'w' by 'h' rectangle at x1/y1 to x2/y2.  Both are
+* clipped to the panel; pixels that would come from or go
+* to off of it aren't copied.
+*
+* Like memmove(), the rectangles can overlap: the rows and
+* columns are copied starting from the side that's moving
+* toward the other, so nothing is overwritten before it's
+* been copied
+*
+* Parameters:
+*   int16_t x1 - left column of the source
+*   int16_t y1 - top row of the source
+*   int16_t x2 - left column of the destination
+*   int16_t y2 - top row of the destination
+*   int16_t w - width
+*   int16_t h - height
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::moveRegion(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t w, int16_t h)
+{
+  // trim both rectangles to the panel together
+  if (x1 < 0)   { w += x1; x2 -= x1; x1 = 0; }
+  if (x2 < 0)   { w += x2; x1 -= x2; x2 = 0; }
+  if (y1 < 0)   { h += y1; y2 -= y1; y1 = 0; }
+  if (y2 < 0)   { h += y2; y1 -= y2; y2 = 0; }
+
+  w = min(w, (int16_t)(WIDTH - max(x1, x2)));
+  h = min(h, (int16_t)(HEIGHT - max(y1, y2)));
+
+  if (w <= 0 || h <= 0 || (x1 == x2 && y1 == y2))
+  {
+    return;
+  }
+
+  int8_t xdir = (x2 > x1) ? -1 : 1;
+  int8_t ydir = (y2 > y1) ? -1 : 1;
+  int16_t col = (xdir > 0) ? 0 : w - 1;
+  int16_t row = (ydir > 0) ? 0 : h - 1;
+
+  for (int16_t n = 0; n < h; ++n, row += ydir)
+  {
+    bool both = false;
+
+#if PIXEL_RUNS
+    // moving sideways, the rows of the top and bottom half that
+    // share buffer bytes can be moved together, whole bytes
+    if (y1 == y2 && !xlatFunc)
+    {
+      int16_t y = y1 + row;
+
+      if ((y % HUB75_PANEL_ROWS) < HALFROW)
+      {
+        both = (row + HALFROW < h);
+      }
+      else if (row >= HALFROW)
+      {
+        // already moved with the row in the top half
+        continue;
+      }
+    }
+#endif
+
+    this->moveRow(x1 + col, y1 + row, x2 + col, y2 + row, w, xdir, both);
+  }
+}
+
+/********************************************************
+* moveRow()
+*********************************************************
+* moveRegion() for one row.  When the panel's columns are
+* in order in the buffer, both ends are mapped to the
+* framebuffer once, and the bytes in between are copied
+* with the bits of the right half of the panel masked
+* (and shifted, between halves).  With 'both', the rows of
+* both halves are moving together, and whole bytes are
+* memmove()d.
+*
+* Otherwise it's one pixel at a time
+*
+* Parameters:
+*   int16_t x1 - first source column
+*   int16_t y1 - source row
+*   int16_t x2 - first destination column
+*   int16_t y2 - destination row
+*   int16_t w - pixels to copy
+*   int8_t dir - 1 to copy left to right, -1 right to left
+*   bool both - the row HALFROW below moves the same way
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::moveRow(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t w, int8_t dir, bool both)
+{
+#if PIXEL_RUNS
+  if (!xlatFunc)
+  {
+    // where the first pixels are, and which way the next ones are
+    int16_t nx1 = x1 + dir;
+    int16_t ny1 = y1;
+    int16_t nx2 = x2 + dir;
+    int16_t ny2 = y2;
+
+    xform(x1, y1);
+    chainMap(x1, y1);
+    xform(nx1, ny1);
+    chainMap(nx1, ny1);
+    xform(x2, y2);
+    chainMap(x2, y2);
+    xform(nx2, ny2);
+    chainMap(nx2, ny2);
+
+    int8_t step1 = nx1 - x1;
+    int8_t step2 = nx2 - x2;
+    uint8_t shift1 = 2;
+    uint8_t shift2 = 2;
+
+    // same as putBuff(); the bottom half is in the high bits
+    if (y1 >= SCANROWS)
+    {
+      y1 -= SCANROWS;
+      shift1 = 5;
+    }
+
+    if (y2 >= SCANROWS)
+    {
+      y2 -= SCANROWS;
+      shift2 = 5;
+    }
+
+#if HUB75_DISPLAY_LIST
+    if (!(clipRows & bit(y2)))
+    {
+      return;
+    }
+#endif
+
+    dirtyRows |= bit(y2);
+
+    if (both)
+    {
+      // the same run of bytes, lowest address first
+      if (step1 < 0)  x1 -= w - 1;
+      if (step2 < 0)  x2 -= w - 1;
+
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        memmove(&pixBuff[plane * SCANROWS + y2][x2], &pixBuff[plane * SCANROWS + y1][x1], w);
+      }
+
+      return;
+    }
+
+    uint8_t keep = (shift2 == 2) ? 0xe3 : 0x1f;
+    const uint8_t* src = &pixBuff[y1][x1];
+    uint8_t* dst = &pixBuff[y2][x2];
+
+    for (int16_t n = 0; n < w; ++n, src += step1, dst += step2)
+    {
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        uint8_t val = src[plane * SCANROWS * BUFFCOLS];
+
+        if (shift1 < shift2)        val <<= 3;
+        else if (shift1 > shift2)   val >>= 3;
+
+        uint8_t& buf = dst[plane * SCANROWS * BUFFCOLS];
+        buf = (buf & keep) | (val & ~keep);
+      }
+    }
+
+    return;
+  }
+#else
+  (void)both;
+#endif
+
+  for (int16_t n = 0; n < w; ++n, x1 += dir, x2 += dir)
   {
-    for(int16_t len = 0; len <= (dst.x2 - dst.x1); ++len)
+    int16_t sx = x1;
+    int16_t sy = y1;
+
+    if (xlatFunc)
+    {
+      this->xlatFunc(sx, sy);
+
+      if (sx >= 0 && sx < WIDTH && sy >= 0 && sy < HEIGHT)
+      {
+        this->setBuff(x2, y2, this->getBuff(sx, sy));
+      }
+    }
+    else
     {
-      this->copyPixel(src.x1 + len, src.y1 + hgt, dst.x1 + len, dst.y1 + hgt);
+      this->putBuff(x2, y2, this->getBuff(sx, sy));
     }
   }
 }
@@ -184,236 +647,1416 @@ void Uno_HUB75_Driver::rectangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
   else
   {
     // fill in the buffer
-    for (int16_t col = x1; col <= x2; ++col)
-    {
-      for (int16_t row = y1; row <= y2; ++row)
-      {
-        this->setPixel(col, row, color);
-      }
-    }
+    this->spanFill(x1, y1, x2, y2, toPixel(color));
   }
 }
 
 /********************************************************
-* line()
+* spanFill()
 *********************************************************
-* Draw a line somewhere on the display.  In general, uses
-* slope-intercept formula
+* Fill a rectangle a whole buffer row at a time instead of
+* a pixel at a time.  The rectangle is clipped to the
+* panel once, then each buffer row gets a masked store for
+* each column (or a memset when both halves of the row are
+* in the rectangle).  A full screen fill is about as fast
+* as fillAll().
+*
+* If there is a translation method, it has to be called
+* for every pixel, so it falls back to setBuff().  So does
+* a 1/4 scan panel, since a rectangle on the panel is
+* scattered all over its framebuffer
 *
 * Parameters:
-*   int16_t x1 - the starting x point
-*   int16_t y1 - the starting y point
-*   int16_t x2 - the ending x point
-*   int16_t y2 - the ending y poing
-*   Uno_HUB75_Driver::Colors color - line and fill color
-*   bool fill - true to fill with color
+*   int16_t x1 - left column (inclusive)
+*   int16_t y1 - top row (inclusive)
+*   int16_t x2 - right column (inclusive), >= x1
+*   int16_t y2 - bottom row (inclusive), >= y1
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
 * Returns
-*   Void
+*   void
 ********************************************************/
-void Uno_HUB75_Driver::line(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors color)
+void Uno_HUB75_Driver::spanFill(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Pixel c)
 {
-  // special case of horizontal line
-  if (y1 == y2)
-  {
-    if (x1 > x2)  swap(x1, x2);
+  // clip to the panel
+  if (x1 < 0)       x1 = 0;
+  if (y1 < 0)       y1 = 0;
+  if (x2 > MAXX)    x2 = MAXX;
+  if (y2 > MAXY)    y2 = MAXY;
 
-    for (int16_t col = x1; col <= x2; ++col)
-    {
-      this->setPixel(col, y1, color);
-    }
-  }
-  // special case of vertical line
-  else if (x1 == x2)
+  if (x1 > x2 || y1 > y2)
   {
-    if (y1 > y2)  swap(y1, y2);
+    return;
+  }
 
+  if (xlatFunc || !HUB75_LINEAR)
+  {
     for (int16_t row = y1; row <= y2; ++row)
     {
-      this->setPixel(x1, row, color);
+      for (int16_t col = x1; col <= x2; ++col)
+      {
+        this->setBuff(col, row, c);
+      }
     }
+
+    return;
   }
-  else
+
+  // Every compile-time transform turns a rectangle into a
+  // rectangle, so move the corners and put them back in order
+  xform(x1, y1);
+  xform(x2, y2);
+
+  if (x1 > x2)  swap(x1, x2);
+  if (y1 > y2)  swap(y1, y2);
+
+  // Each row of panels is a rectangle of its own in the buffer
+  for (int16_t band = y1 / HUB75_PANEL_ROWS; band <= y2 / HUB75_PANEL_ROWS; ++band)
   {
-    // slope-intercept time.  Calculate the 'm' and 'b' for
-    // the general y = mx + b line equation.  Scaling by
-    // 100 instead of using floating point, because fp on 
-    // an 8-bit MCU is ridiculously slow
-    int16_t m = ((y2 * 100) - (y1 * 100)) / (x2 - x1);
-    int16_t b = y1 - ((x1 * m) / 100);
+    int16_t bx1 = x1;
+    int16_t bx2 = x2;
+    int16_t by1 = max(y1, band * HUB75_PANEL_ROWS);
+    int16_t by2 = min(y2, band * HUB75_PANEL_ROWS + HUB75_PANEL_ROWS - 1);
 
-    if (x1 > x2)    swap(x1, x2);
+    chainMap(bx1, by1);
+    chainMap(bx2, by2);
 
-    for (int16_t col = x1; col <= x2; ++col)
-    {
-      this->setPixel(col, (m * col) / 100 + b, color);
-    }
-  }  
-}
+    if (bx1 > bx2)  swap(bx1, bx2);
+    if (by1 > by2)  swap(by1, by2);
 
+    this->fillBuffRect(bx1, by1, bx2, by2, c);
+  }
+}
 
+#if HUB75_BITPLANE
 /********************************************************
-* drawChar()
+* fillBits()
 *********************************************************
-* Draw and ascii character on the panel at the specified
-* coordinates using specified color
-*
-* This method will draw 5x7 pixel bitmapped font 
-* characters on the panel
-*
-* The font characters are stored in flash memory to save
-* RAM; otherwise it would consume another 640 bytes - more
-* than both framebuffers!
+* Set or clear a run of columns in one color line of a
+* buffer row: the bytes at each end are masked, and every
+* whole byte in between (8 columns) is memset()
 *
-* Paramters:
-*   int16_t x - the X coordinate
-*   int16_t y - the Y coordinate
-*   char chr - character to print
-*   Uno_HUB75_Driver::Colors c - the color
+* Parameters:
+*   uint8_t* line - the color line
+*   uint16_t x1 - first column
+*   uint16_t x2 - last column, >= x1
+*   bool set - true to set the bits, false to clear them
 * Returns
 *   void
 ********************************************************/
-void Uno_HUB75_Driver::drawChar(int16_t x, int16_t y, char chr, Uno_HUB75_Driver::Colors c)
+static void fillBits(uint8_t* line, uint16_t x1, uint16_t x2, bool set)
 {
-  // array in RAM to hold character retrieved from FLASH
-  uint8_t flashChr[5];
+  uint8_t* first = line + (x1 >> 3);
+  uint8_t* last = line + (x2 >> 3);
+  uint8_t mask1 = 0xff >> (x1 & 0x07);
+  uint8_t mask2 = 0xff << (7 - (x2 & 0x07));
 
-  // cast to unsigned
-  uint8_t inx = (uint8_t)chr;
+  if (first == last)
+  {
+    mask1 &= mask2;
+  }
 
-  // limit to the first 128 characters
-  if (chr > 0x7f) chr = 0x7f;
+  *first = set ? (*first | mask1) : (*first & ~mask1);
 
-  // the font is 5 columns by 7 rows
-  for (int16_t ii = 0; ii < 5; ++ii)
+  if (first == last)
   {
-    // read this column's byte from FLASH into RAM
-    flashChr[ii] = pgm_read_byte(&font5x7[inx][ii]);
+    return;
   }
 
-  // 5 columns by 7 rows
-  for (int16_t col = 0; col < 5; ++col)
-  {
-    for (int16_t row = 0; row < 7; ++row)
-    {
-      // each row is a bit in the column byte
-      if ((flashChr[col] >> row) & 0x01)
-      {
-        // if the bit is set, set the corresponding pixel
-        this->setPixel(col + x, y - row, c);
-      } // is pixel set 
-    } // looping through 7 rows (Y) for this column
-  } // looping through the 5 columns
+  memset(first + 1, set ? 0xff : 0x00, last - first - 1);
+  *last = set ? (*last | mask2) : (*last & ~mask2);
 }
-
+#endif
 
 /********************************************************
-* drawString()
+* fillBuffRect()
 *********************************************************
-* Draw ascii characters on the panel at the specified
-* coordinates using specified color
-*
-* This method will draw 5x7 pixel bitmapped font 
-* characters on the panel
-*
-* The font characters are stored in flash memory to save
-* RAM; otherwise it would consume another 640 bytes - more
-* than both framebuffers!
+* The part of spanFill() that does the filling, once the
+* rectangle is in buffer coordinates
 *
-* Paramters:
-*   int16_t x - the X coordinate
-*   int16_t y - the Y coordinate
-*   const char* str - string to print
-*   Uno_HUB75_Driver::Colors c - the color
+* Parameters:
+*   int16_t x1 - left buffer column (inclusive)
+*   int16_t y1 - top panel row (inclusive)
+*   int16_t x2 - right buffer column (inclusive), >= x1
+*   int16_t y2 - bottom panel row (inclusive), >= y1
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
 * Returns
 *   void
 ********************************************************/
-void Uno_HUB75_Driver::drawString(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c)
+void Uno_HUB75_Driver::fillBuffRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Pixel c)
 {
-  for (uint8_t ii = 0; ii < strlen(str); ++ii)
+#if !HUB75_BITPLANE
+  uint16_t len = x2 - x1 + 1;
+#endif
+
+  // the buffer rows it can be in: one run of them when it's all in
+  // one half, or every row when it's in both
+  uint8_t first = (y1 >= SCANROWS) ? y1 - SCANROWS : ((y2 >= SCANROWS) ? 0 : y1);
+  uint8_t last = (y2 < SCANROWS) ? y2 : ((y1 < SCANROWS) ? SCANROWS - 1 : y2 - SCANROWS);
+
+  for (uint8_t row = first; row <= last; ++row)
+  {
+    // which halves of this buffer row are in the rectangle
+    bool top = (row >= y1 && row <= y2);
+    bool btm = (row + SCANROWS >= y1 && row + SCANROWS <= y2);
+
+    if (!top && !btm)
+    {
+      continue;
+    }
+
+#if HUB75_DISPLAY_LIST
+    if (!(clipRows & bit(row)))
+    {
+      continue;
+    }
+#endif
+
+    dirtyRows |= bit(row);
+
+    Uno_HUB75_Driver::Pixel pix = c;
+
+#if HUB75_BITPLANE
+    for (uint8_t plane = 0; plane < PLANES; ++plane)
+    {
+      uint8_t code = pix & 0x07;
+      uint8_t* line = pixBuff[plane * SCANROWS + row];
+      pix >>= 3;
+
+      // color lines 0-2 are the top half, 3-5 the bottom
+      for (uint8_t ii = 0; ii < 6; ++ii, line += LINEBYTES)
+      {
+        if (ii < 3 ? top : btm)
+        {
+          fillBits(line, x1, x2, code & bit(ii % 3));
+        }
+      }
+    }
+#else
+    // bits to keep in each byte
+    uint8_t keep = top ? (btm ? 0x00 : 0xe0) : 0x1c;
+
+    for (uint8_t plane = 0; plane < PLANES; ++plane)
+    {
+      uint8_t code = pix & 0x07;
+      uint8_t val = (top ? code << 2 : 0) | (btm ? code << 5 : 0);
+      uint8_t* buf = &pixBuff[plane * SCANROWS + row][x1];
+      pix >>= 3;
+
+      if (!keep)
+      {
+        // both pixels of every byte; nothing to keep
+        memset(buf, val, len);
+      }
+      else
+      {
+        for (uint16_t ii = 0; ii < len; ++ii)
+        {
+          buf[ii] = (buf[ii] & keep) | val;
+        }
+      }
+    }
+#endif
+  }
+}
+
+/********************************************************
+* line()
+*********************************************************
+* Draw a line somewhere on the display.  Horizontal and
+* vertical lines are filled a buffer row at a time; all
+* others use Bresenham's algorithm, which only needs adds
+* and compares for each pixel.
+*
+* The line is clipped to the panel first.  Lines entirely
+* off one side of the panel are thrown out by their
+* Cohen-Sutherland outcodes, and the rest are trimmed to
+* the steps along the major axis that land on the panel,
+* so pixels that would be off screen cost nothing.  The
+* trimming is exact; a clipped line has the same pixels
+* as the unclipped one (for lines up to 16383 pixels long).
+*
+* Parameters:
+*   int16_t x1 - the starting x point
+*   int16_t y1 - the starting y point
+*   int16_t x2 - the ending x point
+*   int16_t y2 - the ending y poing
+*   Uno_HUB75_Driver::Colors color - line and fill color
+* Returns
+*   Void
+********************************************************/
+void Uno_HUB75_Driver::line(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors color)
+{
+  // special case of horizontal line
+  if (y1 == y2)
+  {
+    if (x1 > x2)  swap(x1, x2);
+
+    this->spanFill(x1, y1, x2, y2, toPixel(color));
+    return;
+  }
+
+  // special case of vertical line
+  if (x1 == x2)
+  {
+    if (y1 > y2)  swap(y1, y2);
+
+    this->spanFill(x1, y1, x2, y2, toPixel(color));
+    return;
+  }
+
+  // both ends off the same side of the panel; nothing to draw
+  if (outcode(x1, y1) & outcode(x2, y2))
+  {
+    return;
+  }
+
+  // Lines over 16383 pixels long along either axis would
+  // overflow the 32 bit math below, so cut them in half until
+  // they aren't.  Keep the half that can reach the panel; if
+  // neither half is off to one side and the middle is on the
+  // panel, keep the middle half.  Rounding the new ends can
+  // move these (silly long) lines by a pixel.
+  while (abs((int32_t)x2 - x1) > 16383 || abs((int32_t)y2 - y1) > 16383)
+  {
+    int16_t mx = ((int32_t)x1 + x2) / 2;
+    int16_t my = ((int32_t)y1 + y2) / 2;
+    uint8_t mcode = outcode(mx, my);
+
+    if (outcode(x1, y1) & mcode)
+    {
+      x1 = mx;
+      y1 = my;
+    }
+    else if (outcode(x2, y2) & mcode)
+    {
+      x2 = mx;
+      y2 = my;
+    }
+    else if (mcode)
+    {
+      // misses the panel completely
+      return;
+    }
+    else
+    {
+      x1 = ((int32_t)x1 + mx) / 2;
+      y1 = ((int32_t)y1 + my) / 2;
+      x2 = ((int32_t)x2 + mx) / 2;
+      y2 = ((int32_t)y2 + my) / 2;
+    }
+  }
+
+  // Work along the major axis, calling it X.  For steep lines
+  // that's really Y, so swap the axes here and when plotting
+  bool steep = abs(y2 - y1) > abs(x2 - x1);
+  int16_t maxMajor = MAXX;
+  int16_t maxMinor = MAXY;
+
+  if (steep)
+  {
+    swap(x1, y1);
+    swap(x2, y2);
+    maxMajor = MAXY;
+    maxMinor = MAXX;
+  }
+
+  // always step the major axis in the positive direction
+  if (x1 > x2)
+  {
+    swap(x1, x2);
+    swap(y1, y2);
+  }
+
+  int32_t dx = (int32_t)x2 - x1;
+  int32_t dy = abs((int32_t)y2 - y1);
+  int8_t ystep = (y2 > y1) ? 1 : -1;
+
+  // At step 'k' along X, Y has moved (2 * dy * k + dx) / (2 * dx)
+  // pixels.  Find the first and last steps that are on the panel.
+  int32_t first = (x1 < 0) ? -(int32_t)x1 : 0;
+  int32_t last = (x2 > maxMajor) ? (int32_t)maxMajor - x1 : dx;
+
+  // how far Y may move before it's off the panel, each way
+  int32_t minMove = (ystep > 0) ? -(int32_t)y1 : (int32_t)y1 - maxMinor;
+  int32_t maxMove = (ystep > 0) ? (int32_t)maxMinor - y1 : y1;
+
+  if (maxMove < 0)
+  {
+    return;
+  }
+
+  if (minMove > 0)
+  {
+    // first step that has moved at least minMove
+    int32_t k = (2 * dx * minMove - dx + 2 * dy - 1) / (2 * dy);
+    if (k > first)  first = k;
+  }
+
+  if (maxMove < dy)
+  {
+    // last step that has moved no more than maxMove
+    int32_t k = (2 * dx * (maxMove + 1) - dx + 2 * dy - 1) / (2 * dy) - 1;
+    if (k < last)   last = k;
+  }
+
+  if (first > last)
+  {
+    return;
+  }
+
+  // Bresenham from the first visible step.  From here on it's
+  // all 16 bit; err stays below 2 * dx
+  Uno_HUB75_Driver::Pixel pix = toPixel(color);
+  int32_t start = 2 * dy * first + dx;
+  int16_t x = x1 + first;
+  int16_t y = y1 + ystep * (int16_t)(start / (2 * dx));
+  uint16_t err = start % (2 * dx);
+  uint16_t errX = 2 * dx;
+  uint16_t errY = 2 * dy;
+
+  for (int16_t steps = last - first; steps >= 0; --steps)
+  {
+    if (steep)
+    {
+      this->setBuff(y, x, pix);
+    }
+    else
+    {
+      this->setBuff(x, y, pix);
+    }
+
+    ++x;
+    err += errY;
+
+    if (err >= errX)
+    {
+      err -= errX;
+      y += ystep;
+    }
+  }
+}
+
+/********************************************************
+* outcode()
+*********************************************************
+* Cohen-Sutherland outcode of a point; one bit for each
+* side of the panel the point is off of
+*
+* Parameters:
+*   int16_t x - the X coordinate
+*   int16_t y - the Y coordinate
+* Returns
+*   uint8_t - 0 if on the panel
+********************************************************/
+uint8_t Uno_HUB75_Driver::outcode(int16_t x, int16_t y)
+{
+  uint8_t code = 0;
+
+  if (x < 0)              code |= 0x01;
+  else if (x > MAXX)      code |= 0x02;
+  if (y < 0)              code |= 0x04;
+  else if (y > MAXY)      code |= 0x08;
+
+  return (code);
+}
+
+
+/********************************************************
+* setBuff()
+*********************************************************
+* Translate coordinate system.  By convention (and 
+* imagination), the memory buffer is kind of seen with 
+* (0, 0) being the top left corner.  
+*
+* Maybe you wanna have the origin be somewhere else? 
+* Do that by passing a translation method to this classes
+* init() method, or (faster) with HUB75_TRANSFORM
+*
+* Paramters:
+*   int16_t x - the X coordinate
+*   int16_t y - the Y coordinate
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::setBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c)
+{
+  // if a translation method was specified in the init()
+  // method, then do that translation
+  if (xlatFunc)
+  {
+    this->xlatFunc(x, y);
+  }
+
+  this->putBuff(x, y, c);
+}
+
+
+/********************************************************
+* copyRows()
+*********************************************************
+* Copy the selected buffer rows, in every bit-plane, from
+* one framebuffer to another
+*
+* Parameters:
+*   uint8_t (*dst)[ROWBYTES] - framebuffer to copy to
+*   uint8_t (*src)[ROWBYTES] - framebuffer to copy from
+*   Uno_HUB75_Driver::RowMask rows - bit 'n' set to copy buffer row 'n'
+*   bool blockISR - true to turn off the HUB75 timer ISR while
+*     copying each row
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::copyRows(uint8_t (*dst)[ROWBYTES], uint8_t (*src)[ROWBYTES], Uno_HUB75_Driver::RowMask rows, bool blockISR)
+{
+  for (uint8_t row = 0; rows; ++row, rows >>= 1)
+  {
+    if (rows & 0x01)
+    {
+      // only held off for one row at a time
+      if (blockISR)
+      {
+        HUB75_TIMSK &= ~bit(HUB75_OCIEA);
+      }
+
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        memcpy(dst[plane * SCANROWS + row], src[plane * SCANROWS + row], ROWBYTES);
+      }
+
+      if (blockISR)
+      {
+        HUB75_TIMSK |= bit(HUB75_OCIEA);
+      }
+    }
+  }
+}
+
+#if HUB75_DISPLAY_LIST
+/********************************************************
+* rectRows()
+*********************************************************
+* Find the buffer rows that the pixels of a rectangle
+* are in, as a mask for setClipRows().  A row of the
+* panel is always in one buffer row (a column, when turned
+* on its side), so only one edge needs to be mapped.  With
+* a translation method, or a 1/4 scan panel, any pixel
+* could be anywhere, so it's all of them
+*
+* Parameters:
+*   int16_t x1 - X coordinate of one corner
+*   int16_t y1 - Y coordinate of one corner
+*   int16_t x2 - X coordinate of the opposite corner
+*   int16_t y2 - Y coordinate of the opposite corner
+* Returns
+*   Uno_HUB75_Driver::RowMask - bit 'n' set if any pixel is
+*     in buffer row 'n'; 0 if it's all off the panel
+********************************************************/
+Uno_HUB75_Driver::RowMask Uno_HUB75_Driver::rectRows(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  if (x1 > x2)
+  {
+    int16_t t = x1;
+    x1 = x2;
+    x2 = t;
+  }
+
+  if (y1 > y2)
+  {
+    int16_t t = y1;
+    y1 = y2;
+    y2 = t;
+  }
+
+  x1 = max(x1, (int16_t)0);
+  y1 = max(y1, (int16_t)0);
+  x2 = min(x2, (int16_t)MAXX);
+  y2 = min(y2, (int16_t)MAXY);
+
+  if (x1 > x2 || y1 > y2)
+  {
+    return (0);
+  }
+
+#if HUB75_LINEAR
+  if (!xlatFunc)
+  {
+    Uno_HUB75_Driver::RowMask rows = 0;
+
+#if HUB75_TRANSFORM == HUB75_XFORM_ROT90 || HUB75_TRANSFORM == HUB75_XFORM_ROT270
+    // each column is a row of the panel
+    int16_t first = x1;
+    int16_t last = x2;
+#else
+    int16_t first = y1;
+    int16_t last = y2;
+#endif
+
+    for (int16_t n = first; n <= last && rows != ALLROWS; ++n)
+    {
+#if HUB75_TRANSFORM == HUB75_XFORM_ROT90 || HUB75_TRANSFORM == HUB75_XFORM_ROT270
+      int16_t x = n;
+      int16_t y = y1;
+#else
+      int16_t x = x1;
+      int16_t y = n;
+#endif
+
+      xform(x, y);
+      chainMap(x, y);
+      rows |= bit(y & (SCANROWS - 1));
+    }
+
+    return (rows);
+  }
+#endif
+
+  return (ALLROWS);
+}
+
+/********************************************************
+* clearRows()
+*********************************************************
+* Set every pixel in the selected buffer rows to black,
+* in every bit-plane, whatever the clip rows are
+*
+* Parameters:
+*   Uno_HUB75_Driver::RowMask rows - bit 'n' set to clear
+*     buffer row 'n'
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::clearRows(Uno_HUB75_Driver::RowMask rows)
+{
+  dirtyRows |= rows;
+
+  for (uint8_t row = 0; rows; ++row, rows >>= 1)
+  {
+    if (rows & 0x01)
+    {
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        memset(pixBuff[plane * SCANROWS + row], 0, ROWBYTES);
+      }
+    }
+  }
+}
+#endif
+
+/********************************************************
+* draw()
+*********************************************************
+* This needs to be called after drawing of the panel is
+* complete so that the buffer can be sent out to the panel
+*
+* Only the rows that were drawn on since the last call are
+* copied.  If nothing was drawn, nothing is done.
+*
+* With HUB75_PAGE_FLIP, this only asks update() to swap
+* the buffers at the start of the next frame.  Wait for
+* flipPending() to return false before drawing again; if
+* the last flip is still pending, this does nothing and
+* returns false.
+*
+* With a background (HUB75_LAYERS), the rows are merged
+* with it on the way instead.
+*
+* Returns
+*   bool - false if the frame was dropped because a flip
+*     was pending (what was drawn went into the buffer
+*     about to be shown); true otherwise
+********************************************************/
+#if HUB75_PAGE_FLIP
+bool Uno_HUB75_Driver::draw()
+{
+  // last flip hasn't happened yet; what was drawn since
+  // then went into the buffer that is about to be shown
+  if (pendingFlip)
+  {
+    return (false);
+  }
+
+  // nothing new to show
+  if (!dirtyRows)
+  {
+    return (true);
+  }
+
+  // the drawing buffer may have been drawn on without asking
+  // flipPending() first; bring over the rows that weren't
+  this->flipPending();
+
+  // the buffer being shown now is the next one to draw in,
+  // once update() has let go of it.  The rows drawn on in this
+  // frame will need to be copied over to it after the flip
+  pixBuff = (pixBuff == frameBuff[0]) ? frameBuff[1] : frameBuff[0];
+  syncRows = dirtyRows;
+  dirtyRows = 0;
+  pendingFlip = true;
+
+  return (true);
+}
+
+/********************************************************
+* flipPending()
+*********************************************************
+* Check if the last draw() has been shown yet.  Don't draw
+* anything while this returns true; the drawing buffer is
+* still on the panel.
+*
+* When it returns false the drawing buffer is up to date,
+* since the rows drawn on in the last frame are copied
+* over from the buffer being shown.
+*
+* Returns
+*   bool - true if update() hasn't swapped buffers yet
+********************************************************/
+bool Uno_HUB75_Driver::flipPending()
+{
+  if (pendingFlip)
+  {
+    return (true);
+  }
+
+  if (syncRows)
+  {
+    uint8_t (*shown)[ROWBYTES] = (pixBuff == frameBuff[0]) ? frameBuff[1] : frameBuff[0];
+
+    // don't overwrite anything drawn since
+    this->copyRows(pixBuff, shown, syncRows & ~dirtyRows, false);
+    syncRows = 0;
+  }
+
+  return (false);
+}
+
+/********************************************************
+* flip()
+*********************************************************
+* Swap the output buffer if draw() has asked for it.  Only
+* called by update() at the start of a frame, so the
+* panel never shows part of two frames
+********************************************************/
+void Uno_HUB75_Driver::flip()
+{
+  if (pendingFlip)
+  {
+    updBuff = (updBuff == frameBuff[0]) ? frameBuff[1] : frameBuff[0];
+    pendingFlip = false;
+#if HUB75_STATS
+    ++counts.flips;
+#endif
+#if HUB75_STREAM
+    // tell the host; when it's sent, the transmit ISR puts what
+    // came in meanwhile into the new drawing buffer
+    if (streaming)
+    {
+      UDR0 = HUB75_STREAM_ACK;
+    }
+#endif
+  }
+}
+#else
+bool Uno_HUB75_Driver::draw()
+{
+  // copy the changed rows of the drawing framebuffer to the
+  // active framebuffer.  If using ISR for update, it's disabled
+  // for each row to prevent flickering.  With one framebuffer
+  // update() is already showing them
+#if !HUB75_SINGLE_BUFFER
+#if HUB75_LAYERS
+  if (background)
+  {
+    this->mergeRows(dirtyRows, usingISR);
+  }
+  else
+#endif
+  this->copyRows(updBuff, pixBuff, dirtyRows, usingISR);
+#endif
+#if HUB75_STATS
+  if (dirtyRows)
+  {
+    ++counts.flips;
+  }
+#endif
+  dirtyRows = 0;
+
+  return (true);
+}
+
+// nothing to do; draw() copies
+inline void Uno_HUB75_Driver::flip() {}
+#endif
+
+#if HUB75_BITPLANE
+/********************************************************
+* shiftRow()
+*********************************************************
+* HUB75_BITPLANE version.  Shift one row of color data
+* (top and bottom half) into the panel's shift registers,
+* putting each column back together from its bit in each
+* of the 6 color lines.  Doesn't touch OE, so what ever
+* row was latched before stays lit meanwhile
+*
+* For every 8 columns, one byte of each line is loaded
+* (6 ldd, 12 cycles).  Then each column is unrolled, with
+* the bit to test known at compile time:
+*
+*   mov  r, low        1 cycle    UART pins as-is
+*   sbrc line, n       \
+*   ori  r, bit        /  2 x 6   one per color line
+*   out  PORTD, r      1          both pixels
+*   out  PINB, clk     1          CLK high
+*   out  PINB, clk     1          CLK low
+*
+* That's about 18 cycles a column, or 570 cycles (36 us)
+* for a row of 32, counted from the instruction timings;
+* 3 times the 192 of the byte per column layout.
+*
+* Parameters:
+*   const uint8_t* row - first byte of the buffer row
+* Returns
+*   void
+********************************************************/
+
+// one column: bit 'n' of each line's byte onto its color line,
+// then a clock pulse
+#define SHIFT_BIT(n)    { uint8_t b = low;                             \
+                          if (r1 & bit(n))  b |= bit(PIN_RF);          \
+                          if (g1 & bit(n))  b |= bit(PIN_GF);          \
+                          if (b1 & bit(n))  b |= bit(PIN_BF);          \
+                          if (r2 & bit(n))  b |= bit(PIN_RS);          \
+                          if (g2 & bit(n))  b |= bit(PIN_GS);          \
+                          if (b2 & bit(n))  b |= bit(PIN_BS);          \
+                          HUB75_COLOR_PORT = b; HUB75_CTL_PINS = clk; HUB75_CTL_PINS = clk; }
+
+// 8 columns, leftmost in the top bit
+#define SHIFT_BYTE()    { uint8_t r1 = row[0 * LINEBYTES];             \
+                          uint8_t g1 = row[1 * LINEBYTES];             \
+                          uint8_t b1 = row[2 * LINEBYTES];             \
+                          uint8_t r2 = row[3 * LINEBYTES];             \
+                          uint8_t g2 = row[4 * LINEBYTES];             \
+                          uint8_t b2 = row[5 * LINEBYTES];             \
+                          ++row;                                       \
+                          SHIFT_BIT(7); SHIFT_BIT(6); SHIFT_BIT(5);    \
+                          SHIFT_BIT(4); SHIFT_BIT(3); SHIFT_BIT(2);    \
+                          SHIFT_BIT(1); SHIFT_BIT(0); }
+
+void Uno_HUB75_Driver::shiftRow(const uint8_t* row)
+{
+  // the UART pins, as in the byte per column version
+  uint8_t low = HUB75_COLOR_PORT & 0x03;
+  uint8_t clk = bit(PIN_CLK);
+
+  // one pass per 32 columns of the chain
+  for (uint8_t ii = 0; ii < SHIFTCOLS / 32; ++ii)
+  {
+    SHIFT_BYTE();
+    SHIFT_BYTE();
+    SHIFT_BYTE();
+    SHIFT_BYTE();
+  }
+}
+#else
+/********************************************************
+* shiftRow()
+*********************************************************
+* Shift one row of color data (top and bottom half) into
+* the panel's shift registers.  Doesn't touch OE, so what
+* ever row was latched before stays lit meanwhile
+*
+* All of the columns are unrolled, and each one is just:
+*
+*   ld  r, Z+       2 cycles   next byte of the row
+*   or  r, low      1          keep the UART pins as-is
+*   out PORTD, r    1          both pixels on the color lines
+*   out PINB, clk   1          CLK high (writing PINB toggles)
+*   out PINB, clk   1          CLK low
+*
+* That's 6 cycles a column, or 192 cycles (12 us) for a
+* row of 32, counted from the instruction timings.  Each
+* more panel in a chain adds another 192.  The
+* old loop did two read-modify-writes of PORTD and two of
+* PORTB for every column and took about 17 cycles.
+*
+* Bits 0 and 1 of each buffer byte are never set by the
+* drawing methods, so they aren't masked off here.
+*
+* Parameters:
+*   const uint8_t* row - first column of the buffer row
+* Returns
+*   void
+********************************************************/
+
+// one column: both pixels on the color lines, then a clock pulse
+#define SHIFT_COL()     { HUB75_COLOR_PORT = *row++ | low; HUB75_CTL_PINS = clk; HUB75_CTL_PINS = clk; }
+#define SHIFT_8COLS()   { SHIFT_COL(); SHIFT_COL(); SHIFT_COL(); SHIFT_COL(); \
+                          SHIFT_COL(); SHIFT_COL(); SHIFT_COL(); SHIFT_COL(); }
+
+void Uno_HUB75_Driver::shiftRow(const uint8_t* row)
+{
+  // get the lower 2 bits once - we don't want to change them; on
+  // the Uno they are the RX/TX pins of the UART which may be used
+  // for something else
+  uint8_t low = HUB75_COLOR_PORT & 0x03;
+  uint8_t clk = bit(PIN_CLK);
+
+  // one pass per 32 columns of the chain
+  for (uint8_t ii = 0; ii < SHIFTCOLS / 32; ++ii)
+  {
+    SHIFT_8COLS();
+    SHIFT_8COLS();
+    SHIFT_8COLS();
+    SHIFT_8COLS();
+  }
+}
+#endif
+
+/********************************************************
+* latchRow()
+*********************************************************
+* Select a row address and latch the shifted data into
+* the panel's output registers, then turn output on
+*
+* Parameters:
+*   uint8_t thisRow - row address, 0 to SCANROWS - 1
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::latchRow(uint8_t thisRow)
+{
+  // turn off output
+  SETBIT_CTL(PIN_OE);
+
+  // set row; A, B and C are together with the control lines, and
+  // 1/16 scan panels have D on its own pin
+  HUB75_CTL_PORT = (HUB75_CTL_PORT & ~0x07) | (thisRow & 0x07);
+#if SCANROWS > 8
+  if (thisRow & 0x08)   SETBIT_RD();
+  else                  CLRBIT_RD();
+#endif
+
+  // latch this row
+  SETBIT_CTL(PIN_LAT);
+  CLRBIT_CTL(PIN_LAT);
+
+  // turn output back on
+  CLRBIT_CTL(PIN_OE);
+}
+
+#if HUB75_NAKED_ISR
+// HUB75 timer ticks (64 cycles) from the compare match until the
+// naked ISR has latched a row; about 40 cycles plus 6 a column
+#define NAKED_LATCH_TICKS   ((40 + 6 * SHIFTCOLS) / 64 + 1)
+#endif
+
+/********************************************************
+* setBrightness()
+*********************************************************
+* Set how long each row is lit, from 0 (off) to 255 (the
+* whole time, which is the default).
+*
+* OE isn't on a pin any timer can drive, so with the Timer
+* 2 ISR in the one-row-per-call modes, the compare B
+* interrupt turns it off after the row has been lit for
+* level/256 of the period; the CPU is free meanwhile.  In
+* BCM mode that's each bit-plane's period, so the lowest
+* plane runs out of ticks first (at a level under 16 with
+* the default HUB75_BCM_BASE).
+*
+* The full frame update() shortens its busy-wait instead.
+* The one-row-per-call modes can't dim without the ISR.
+*
+* Parameters:
+*   uint8_t level - 0 to 255
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::setBrightness(uint8_t level)
+{
+  brightness = level;
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  if (!usingISR)
+  {
+    return;
+  }
+
+#if HUB75_NAKED_ISR
+  // the naked ISR latches at about the same count every time,
+  // so the compare value doesn't change from row to row
+  uint8_t on = ((uint16_t)(HUB75_OCRA + 1) * level) >> 8;
+  uint8_t off = NAKED_LATCH_TICKS + (on ? on : 1);
+
+  HUB75_OCRB = (off < HUB75_OCRA) ? off : HUB75_OCRA - 1;
+#endif
+
+  // at full brightness a row stays lit until the next one; compare
+  // B isn't needed, and matching with compare A would turn it off
+  if (level == 255)
+  {
+    HUB75_TIMSK &= ~bit(HUB75_OCIEB);
+  }
+  else
+  {
+    HUB75_TIFR = bit(HUB75_OCFB);
+    HUB75_TIMSK |= bit(HUB75_OCIEB);
+  }
+#endif
+}
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+/********************************************************
+* dimRow()
+*********************************************************
+* Set the HUB75 timer's compare B for when the row that
+* was just latched goes dark, 'brightness' 256ths of the
+* period from now.  It's kept at least a tick ahead of compare A,
+* since the compare B ISR would run right after the next
+* row is latched otherwise
+********************************************************/
+inline void Uno_HUB75_Driver::dimRow()
+{
+  if (!usingISR || brightness == 255)
   {
-    this->drawChar(x, y, str[ii], c);
-    
-    // index 6 pixels right for the next char
-    x += 6;
+    return;
+  }
+
+  uint8_t top = HUB75_OCRA;
+  uint8_t now = HUB75_TCNT;
+  uint16_t off = now + (((uint16_t)(top + 1) * brightness) >> 8);
+
+  if (off >= top)
+  {
+    off = top - 1;
+  }
+
+  HUB75_OCRB = off;
+
+  // a match from the last row's compare value may be pending,
+  // or the count may already be past this one
+  HUB75_TIFR = bit(HUB75_OCFB);
+  if (HUB75_TCNT >= off)
+  {
+    SETBIT_CTL(PIN_OE);
   }
 }
 
 /********************************************************
-* setBuff()
+* HUB75 TIMER COMPARE B ISR
 *********************************************************
-* Translate coordinate system.  By convention (and 
-* imagination), the memory buffer is kind of seen with 
-* (0, 0) being the top left corner.  
+* End of the lit part of a row for setBrightness().  The
+* port write is a single sbi, which doesn't touch SREG or
+* any registers, so nothing needs saving
+********************************************************/
+ISR(HUB75_TIMER_B_VECT, ISR_NAKED)
+{
+  SETBIT_CTL(PIN_OE);
+  reti();
+}
+#endif
+
+/********************************************************
+* startFrame()
+*********************************************************
+* update() calls this before the first row of each frame.
+* Swaps buffers if draw() asked, and picks up the
+* viewport, so a frame never shows two of either
+********************************************************/
+inline void Uno_HUB75_Driver::startFrame()
+{
+  this->flip();
+
+#if HUB75_STATS
+  ++counts.frames;
+#endif
+
+#if HUB75_VIRTUAL_COLS
+  frameX = viewX;
+  frameY = viewY;
+#endif
+}
+
+#if HUB75_VIRTUAL_COLS
+/********************************************************
+* shiftBuffRow()
+*********************************************************
+* Shift out what the panel shows at one row address.  The
+* panel's columns start at column 'frameX' of the buffer,
+* wrapping around to column 0, and its rows are rolled up
+* by 'frameY'.
 *
-* Maybe you wanna have the origin be somewhere else? 
-* Do that by passing a translation method to this classes
-* init() method
+* Rolling by less than SCANROWS (or more) can put a row from
+* the bottom half of the buffer in the top half of the
+* panel; then each byte has its halves swapped as it's
+* shifted out, which costs about 5 cycles a column
 *
-* Paramters:
-*   int16_t x - the X coordinate
-*   int16_t y - the Y coordinate
-*   Uno_HUB75_Driver::Colors c - the color
+* Parameters:
+*   uint8_t plane - bit-plane, 0 in classic mode
+*   uint8_t row - row address, 0 to SCANROWS - 1
 * Returns
 *   void
 ********************************************************/
-void Uno_HUB75_Driver::setBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Colors c)
+inline void Uno_HUB75_Driver::shiftBuffRow(uint8_t plane, uint8_t row)
 {
-  // if a translation method was specified in the init()
-  // method, then do that translation
-  if (xlatFunc)
+  // panel row 'row' shows buffer row 'src'
+  uint8_t src = row + frameY;
+  if (src >= ROWS)    src -= ROWS;
+
+  bool swap = (src >= SCANROWS);
+  if (swap)           src -= SCANROWS;
+
+  const uint8_t* cols = updBuff[plane * SCANROWS + src];
+  uint16_t first = BUFFCOLS - frameX;
+  if (first > SHIFTCOLS)  first = SHIFTCOLS;
+
+  shiftCols(cols + frameX, first, swap);
+  shiftCols(cols, SHIFTCOLS - first, swap);
+}
+
+/********************************************************
+* shiftCols()
+*********************************************************
+* Like shiftRow(), for any number of columns, and
+* optionally swapping the top and bottom half pixels of
+* every byte.  Unrolled 8 columns at a time with a switch
+* into the middle for the rest (Duff's device)
+*
+* Parameters:
+*   const uint8_t* cols - first column to shift out
+*   uint16_t count - how many columns
+*   bool swap - true to swap the halves of each byte
+* Returns
+*   void
+********************************************************/
+
+// one column with its halves swapped
+#define SHIFT_SWAP()    { uint8_t b = *cols++; \
+                          HUB75_COLOR_PORT = (((uint8_t)(b << 3) | (b >> 3)) & 0xfc) | low; \
+                          HUB75_CTL_PINS = clk; HUB75_CTL_PINS = clk; }
+
+// the cases below fall through on purpose.  A "fall through"
+// comment doesn't survive the macro, so it's the attribute, where
+// the compiler has it (GCC 7 and up, which warns without it)
+#if defined(__GNUC__) && __GNUC__ >= 7
+#define FALL_THROUGH    __attribute__((fallthrough))
+#else
+#define FALL_THROUGH
+#endif
+
+// Duff's device around one of the column macros
+#define SHIFT_DUFF(col) { uint8_t n = (count + 7) / 8;                 \
+                          switch (count % 8)                           \
+                          {                                            \
+                            case 0: do { col(); FALL_THROUGH;          \
+                            case 7:      col(); FALL_THROUGH;          \
+                            case 6:      col(); FALL_THROUGH;          \
+                            case 5:      col(); FALL_THROUGH;          \
+                            case 4:      col(); FALL_THROUGH;          \
+                            case 3:      col(); FALL_THROUGH;          \
+                            case 2:      col(); FALL_THROUGH;          \
+                            case 1:      col();                        \
+                                       } while (--n);                  \
+                          } }
+
+void Uno_HUB75_Driver::shiftCols(const uint8_t* cols, uint16_t count, bool swap)
+{
+  uint8_t low = HUB75_COLOR_PORT & 0x03;
+  uint8_t clk = bit(PIN_CLK);
+
+  if (!count)
   {
-    this->xlatFunc(x, y);
+    return;
   }
 
-  // memory buffer is set up as [row][column], or 
-  // think of it as [Y][X].  Maybe backwards, but
-  // it makes looping through the drive more clean
-
-  // We're using 8 colors on the panel (black, red, green, blue,
-  // yellow, cyan, magenta).  That only takes 3 bits.  To save
-  // RAM on this small micro, we'll use the lower 4 bits of each
-  // buffer byte to be the "top" half of the physical display
-  // and the upper 4 bytes for the "bottom" half of the physical
-  // display
-  if (y < HALFROW)
+  if (swap)
   {
-    // mask off the top 3 bits (5, 6, and 7) and or it with the color (shifted left 2 bits)
-    pixBuff[y][x] = (uint8_t)(((pixBuff[y][x] & 0xe0) | (c << 2)) & 0xff);
+    SHIFT_DUFF(SHIFT_SWAP);
   }
   else
   {
-    // mask off bits 2, 3, and 4 (the color bits for the upper half), and or it with the
-    // 3 color bits for the upper half
-    pixBuff[y - HALFROW][x] = (uint8_t)(((pixBuff[y - HALFROW][x] & 0x1c) | (c << 5)) & 0xff); 
+    // shiftRow()'s column, reading from 'cols'
+    const uint8_t* row = cols;
+    SHIFT_DUFF(SHIFT_COL);
   }
 }
 
+/********************************************************
+* setViewport()
+*********************************************************
+* Pick the part of the (wider than the panel) framebuffer
+* that the panel shows.  Nothing is redrawn or copied;
+* update() just starts reading from somewhere else at the
+* start of the next frame.  Both coordinates wrap around,
+* so counting up or down forever scrolls a marquee
+*
+* Parameters:
+*   int16_t x - buffer column at the left edge of the panel
+*   int16_t y - buffer row at the top of the panel
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::setViewport(int16_t x, int16_t y)
+{
+  x %= BUFFCOLS;
+  y %= ROWS;
+
+  // each one is a single byte, so update() never sees half
+  // of a change
+  viewX = (x < 0) ? x + BUFFCOLS : x;
+  viewY = (y < 0) ? y + ROWS : y;
+}
+#else
+// no viewport; shift out the row as it is
+inline void Uno_HUB75_Driver::shiftBuffRow(uint8_t plane, uint8_t row)
+{
+  this->shiftRow(updBuff[plane * SCANROWS + row]);
+}
+#endif
+
+#if HUB75_STATS
+/********************************************************
+* statsEnter()
+*********************************************************
+* Start timing a call to update().  In CTC mode the HUB75
+* timer counts up from 0 at the compare match, so the
+* count now is how late the ISR started, and the count at
+* statsLeave() is how long it took from the match
+********************************************************/
+inline void Uno_HUB75_Driver::statsEnter()
+{
+  ++counts.updates;
+  counts.entryTicks = HUB75_TCNT;
+}
 
 /********************************************************
-* draw()
+* statsLeave()
 *********************************************************
-* This needs to be called after drawing of the panel is
-* complete so that the buffer can be sent out to the panel
+* Add the time update() took to the counts.  If the timer
+* passed the compare match meanwhile, the next ISR is
+* already due; that's an overlap, and the count started
+* over at 0.  That's only counted once; taking longer than
+* two periods can't be seen from in here.
+*
+* HUB75_OCRA is read at the end since the BCM update() changes
+* it for the period it's in
 ********************************************************/
-void Uno_HUB75_Driver::draw()
+inline void Uno_HUB75_Driver::statsLeave()
 {
-  // if using ISR for update, disable it during
-  // the memcpy operation to prevent flickering
-  if (usingISR)
+  if (!usingISR)
   {
-    TIMSK2 &= ~bit(OCIE2A);
+    return;
   }
-  
-  // copy drawing framebuffer to active framebuffer
-  memcpy(updBuff, pixBuff, HALFROW * COLS);
-  
-  // re-enable ISR
+
+  uint16_t ticks = HUB75_TCNT;
+  uint16_t period = (uint16_t)HUB75_OCRA + 1;
+
+  if (HUB75_TIFR & bit(HUB75_OCFA))
+  {
+    ticks += period;
+    if (counts.overlaps != 0xffff)    ++counts.overlaps;
+  }
+
+  // late by more than a quarter of the period
+  if (counts.entryTicks > period / 4)
+  {
+    if (counts.late != 0xffff)        ++counts.late;
+  }
+
+  if (ticks > 0xff)                   ticks = 0xff;
+  if (ticks > counts.maxTicks)        counts.maxTicks = ticks;
+
+  counts.busy += ticks;
+  counts.period += period;
+}
+
+/********************************************************
+* getStats()
+*********************************************************
+* Copy the refresh counters.  The timing fields are only
+* filled in when begin() started the HUB75 timer ISR.
+* Ticks are 4 us with HUB75_BCM_BITS or HUB75_SCANLINE_ISR, and
+* 16 us for the full frame update(); 'usPerTick' says
+* which.
+*
+* The flip count is draw()s that changed something, and
+* with HUB75_PAGE_FLIP, were swapped in by update()
+*
+* Parameters:
+*   Uno_HUB75_Driver::Stats& s - filled in with the counts
+*   bool reset - true to start the counts over
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::getStats(Uno_HUB75_Driver::Stats& s, bool reset)
+{
+  // the ISR adds to the counts; hold it off while copying
+  uint8_t mask = HUB75_TIMSK;
+  HUB75_TIMSK = mask & ~bit(HUB75_OCIEA);
+
+  s.frames = counts.frames;
+  s.flips = counts.flips;
+  s.updates = counts.updates;
+  s.maxTicks = counts.maxTicks;
+  s.late = counts.late;
+  s.overlaps = counts.overlaps;
+
+  uint32_t busy = counts.busy;
+  uint32_t period = counts.period;
+
+  if (reset)
+  {
+    memset(&counts, 0, sizeof(counts));
+  }
+
+  HUB75_TIMSK = mask;
+
+  // nothing is timed without the ISR.  Overlapping calls
+  // count more than their period, so the load can go over
+  if (period)
+  {
+    uint32_t load = (busy * 100UL) / period;
+
+    s.avgTicks = busy / s.updates;
+    s.loadPercent = (load > 100) ? 100 : load;
+  }
+  else
+  {
+    s.avgTicks = 0;
+    s.loadPercent = 0;
+  }
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  s.usPerTick = 4;
+#else
+  s.usPerTick = 16;
+#endif
+}
+#else
+inline void Uno_HUB75_Driver::statsEnter() {}
+inline void Uno_HUB75_Driver::statsLeave() {}
+#endif
+
+#if HUB75_BCM_BITS
+/********************************************************
+* update()
+*********************************************************
+* BCM version.  Each call shifts out ONE bit-plane of ONE
+* row and latches it, and then leaves it lit until the
+* next call.  Bit-plane 'n' is lit for HUB75_BCM_BASE << n
+* timer ticks by reloading HUB75_OCRA, so the planes add up to
+* 2^PLANES brightness levels.
+*
+* A full frame is PLANES * SCANROWS calls.  Each call takes
+* about 22 us at 16 MHz including the ISR's entry and exit,
+* so with the default base of 16 ticks (64 us):
+*
+*   bits   frame     refresh   CPU used by update()
+*     2    1.5 ms    650 Hz    ~23%
+*     3    3.6 ms    280 Hz    ~15%
+*     4    7.7 ms    130 Hz    ~9%
+*
+* The worst case is while the least significant plane is
+* lit: 22 us of every 64 us.  A longer HUB75_BCM_BASE
+* lowers the CPU use at the expense of refresh rate.
+*
+* If not using the ISR, the weighting is done with a busy
+* wait instead, which ties up the CPU for the whole frame.
+********************************************************/
+void Uno_HUB75_Driver::update()
+{
+  this->statsEnter();
+
+  uint8_t plane = scanPlane;
+  uint8_t row = scanRow;
+
+  // start of a frame; swap buffers if draw() asked
+  if (!(plane | row))
+  {
+    this->startFrame();
+  }
+
+  // the time until the next compare match is how long the
+  // data latched below stays lit, so set it first thing
   if (usingISR)
   {
-    TIMSK2 |= bit(OCIE2A);
+    HUB75_OCRA = (HUB75_BCM_BASE << plane) - 1;
+  }
+
+  this->shiftBuffRow(plane, row);
+  this->latchRow(row);
+  this->dimRow();
+
+  if (!usingISR)
+  {
+    // 4 us per tick, same as the timer would have been
+    for (uint8_t ii = 0; ii < (1 << plane); ++ii)
+    {
+      delayMicroseconds(HUB75_BCM_BASE * 4);
+    }
+  }
+
+  // next bit-plane; after the last one move to the next row
+  if (++plane >= PLANES)
+  {
+    plane = 0;
+    row = (row + 1) & (SCANROWS - 1);
   }
+
+  scanPlane = plane;
+  scanRow = row;
+
+  this->statsLeave();
 }
+#elif HUB75_SCANLINE_ISR
+/********************************************************
+* update()
+*********************************************************
+* One-row-per-call version.  Each call shifts out and
+* latches a single row, and leaves it lit until the next
+* call, so the panel is refreshed once every SCANROWS calls.
+*
+* begin() sets the HUB75 timer to 252 us for this, which
+* refreshes the panel every 2 ms, the same as the full
+* frame version.
+* Each call takes about 22 us including the ISR's entry and
+* exit, short enough to not drop UART bytes at 115200 baud.
+* With HUB75_NAKED_ISR it's about 17 us.
+*
+* Other scan types keep the 2 ms refresh by changing the
+* timer period to fit the number of row addresses:
+*
+*   scan   rows   period    per call   CPU used
+*   1/4     4     504 us    ~34 us     ~7%
+*   1/8     8     252 us    ~22 us     ~9%
+*   1/16   16     124 us    ~23 us     ~19%
+*
+* (1/4 scan rows are twice as wide to shift.)
+*
+* Since rows are lit for the whole period instead of for a
+* short busy-wait, the panel is also a lot brighter.
+********************************************************/
+void Uno_HUB75_Driver::update()
+{
+  this->statsEnter();
+
+  uint8_t row = scanRow;
+
+  // start of a frame; swap buffers if draw() asked
+  if (!row)
+  {
+    this->startFrame();
+  }
+
+  this->shiftBuffRow(0, row);
+  this->latchRow(row);
+  this->dimRow();
 
+  scanRow = (row + 1) & (SCANROWS - 1);
+
+  this->statsLeave();
+}
+#else
 /********************************************************
 * update()
 *********************************************************
@@ -424,60 +2067,295 @@ void Uno_HUB75_Driver::draw()
 * for decent results.
 *
 * With the clock at 16 MHz, this routine was measured to 
-* take a total of 440 us (microseconds).  If you call the
-* routine every 2 ms, you will be using just under a 
-* quarter of the horsepower of a ATMega 328.
+* take a total of 440 us (microseconds) with the original
+* column loop, on a scope.  With the unrolled shiftRow()
+* it's about 8 * (192 + 20 + 240) cycles, or 230 us, and
+* more than half of that is the brightness delay below.
+* That's counted from the instruction timings, not
+* measured; the benchmark's "update" line measures it.  If
+* you call the routine every 2 ms, you will be using just
+* over a tenth of the horsepower of a ATMega 328.
+*
+* That's for 1/8 scan.  A 1/16 scan panel has twice the
+* rows, about 450 us, and 1/4 scan half the rows but twice
+* the columns, about 170 us (also counted).
+*
+* Each row is lit for the delay after it's latched and
+* while the next one is shifted in.  Below full brightness
+* it's lit for a share of that, and turned off before the
+* next shift, so a dimmer panel also takes less time.
+* The delay is a busy-wait either way; the CPU only gets
+* that time back with HUB75_SCANLINE_ISR or BCM, where the
+* HUB75 timer's compare B turns the row off
 ********************************************************/
+
+// delay loops a row is lit for; a loop is about 4 cycles,
+// so shifting the next row in is about 1.5 loops a column
+#define ROW_LIT_LOOPS     60
+#define ROW_SHIFT_LOOPS   (SHIFTCOLS * 3 / 2)
+
 void Uno_HUB75_Driver::update()
 {
-  for (uint8_t thisRow = 0; thisRow < HALFROW; ++thisRow)
+  this->statsEnter();
+
+  // swap buffers if draw() asked
+  this->startFrame();
+
+  // lit time for the brightness, and whether the row can stay
+  // lit while the next one is shifted in
+  uint16_t lit = ((uint32_t)(ROW_LIT_LOOPS + ROW_SHIFT_LOOPS) * (brightness + 1)) >> 8;
+  bool litShift = (lit >= ROW_SHIFT_LOOPS);
+
+  if (litShift)
   {
-    // get a pointer to the first column of this row
-    uint8_t* row = updBuff[thisRow];
-    
-    // fill in all of the columns for this row and the 
-    // corresponding "lower" row.
-    for (uint8_t ii = 0; ii < COLS; ++ii)
+    lit -= ROW_SHIFT_LOOPS;
+  }
+
+  for (uint8_t thisRow = 0; thisRow < SCANROWS; ++thisRow)
+  {
+    // shift out this row and the corresponding "lower" row
+    this->shiftBuffRow(0, thisRow);
+    this->latchRow(thisRow);
+
+    // Delay a bit for added PoV brightness of the display.  Could be
+    // longer at the expense of processing bandwidth.  Without the 
+    // _NOP(), the compiler will optimize this loop away
+    for (uint16_t ii = 0; ii < lit; ++ii) _NOP();
+
+    if (!litShift)
     {
-      CLRBIT_CTL(PIN_CLK);
+      SETBIT_CTL(PIN_OE);
+    }
+  }
+  
+  SETBIT_CTL(PIN_OE);
+  ++scanFrames;
 
-      // get the lower 2 bits - we don't want to change them; they are
-      // the RX/TX pins of the UART which may be used for something else
-      PORTD &= 0x03;
+  this->statsLeave();
+}
+#endif
 
-      // The panel framebuffer is storing the top physical half in bits 2, 3, and 4
-      // of each byte, while the lower physical half is in bits 5, 6, and 7
-      // of each byte - hence the masking
-      PORTD |= *row & 0xfc;
+#if HUB75_NAKED_ISR
+/********************************************************
+* Scan state for the naked HUB75 timer ISR.  It lives out
+* here instead of in the class so the assembler can get at
+* it by name.  begin() fills it in.
+********************************************************/
+static struct
+{
+  const uint8_t* rowPtr;    // next row of the output buffer to shift out
+  const uint8_t* frame;     // first row of the output buffer
+  uint8_t row;              // row address of rowPtr
+} nakedScan __attribute__((used));
 
-      // next pixel in this row
-      ++row;
+// 1/16 scan: the D line is row bit 3, which would land on the CLK
+// bit of the control port too, so clear that (CLK is low here) and
+// set D
+#if SCANROWS > 8
+#define NAKED_ROW_CLK   "andi r18, 0xf7           \n\t"
+#define NAKED_ROW_D     "cbi  %[portrd], %[rd]    \n\t" \
+                        "sbrc r19, 3              \n\t" \
+                        "sbi  %[portrd], %[rd]    \n\t"
+#else
+#define NAKED_ROW_CLK   ""
+#define NAKED_ROW_D     ""
+#endif
 
-      // clock this column in
-      SETBIT_CTL(PIN_CLK);
-    }
+/********************************************************
+* HUB75 TIMER ISR
+*********************************************************
+* Hand written one-row-per-interrupt update().  Only
+* saves the 5 registers (and SREG) that it uses instead of
+* all of the call-clobbered ones a C ISR has to save
+* before calling update().  Per row, in cycles:
+*
+*   entry, save registers     ~20
+*   shift 32 columns          192  (same as shiftRow(),
+*                                  per panel in the chain)
+*   latch, next row            ~25
+*   restore, reti             ~20
+*
+* About 260 cycles (16.5 us) a row, 130 us a frame.
+********************************************************/
+ISR(HUB75_TIMER_VECT, ISR_NAKED)
+{
+  asm volatile(
+    "push r0                  \n\t"
+    "in   r0, __SREG__        \n\t"
+    "push r0                  \n\t"
+    "push r18                 \n\t"
+    "push r19                 \n\t"
+    "push r30                 \n\t"
+    "push r31                 \n\t"
 
-    // turn off output
-    SETBIT_CTL(PIN_OE);
+    // Z = next row, r18 = UART pins (on the Uno), r19 = CLK bit
+    "lds  r30, %[ptr]         \n\t"
+    "lds  r31, %[ptr]+1       \n\t"
+    "in   r18, %[color]       \n\t"
+    "andi r18, 0x03           \n\t"
+    "ldi  r19, %[clk]         \n\t"
 
-    // set row
-    PORTB &= ~0x07;
-    PORTB |= thisRow & 0x07;
+    // shift out every column
+    ".rept %[cols]            \n\t"
+    "ld   r0, Z+              \n\t"
+    "or   r0, r18             \n\t"
+    "out  %[color], r0        \n\t"
+    "out  %[ctlpins], r19     \n\t"
+    "out  %[ctlpins], r19     \n\t"
+    ".endr                    \n\t"
 
-    // latch this row
-    SETBIT_CTL(PIN_LAT);
-    CLRBIT_CTL(PIN_LAT);
+    // output off, set row address, latch, output on
+    "sbi  %[ctl], %[oe]       \n\t"
+    "lds  r19, %[row]         \n\t"
+    "in   r18, %[ctl]         \n\t"
+    "andi r18, 0xf8           \n\t"
+    "or   r18, r19            \n\t"
+    NAKED_ROW_CLK
+    "out  %[ctl], r18         \n\t"
+    NAKED_ROW_D
+    "sbi  %[ctl], %[lat]      \n\t"
+    "cbi  %[ctl], %[lat]      \n\t"
+    "cbi  %[ctl], %[oe]       \n\t"
 
-    // turn output back on
-    CLRBIT_CTL(PIN_OE);
+    // next row; back to the top of the buffer after the last one
+    "inc  r19                 \n\t"
+    "andi r19, %[rowmask]     \n\t"
+    "brne 1f                  \n\t"
+    "lds  r30, %[frame]       \n\t"
+    "lds  r31, %[frame]+1     \n\t"
+    "1:                       \n\t"
+    "sts  %[row], r19         \n\t"
+    "sts  %[ptr], r30         \n\t"
+    "sts  %[ptr]+1, r31       \n\t"
 
-    // Delay a bit for added PoV brightness of the display.  Could be
-    // longer at the expense of processing bandwidth.  Without the 
-    // _NOP(), the compiler will optimize this loop away
-    for (uint8_t ii = 0; ii < 60; ++ii) _NOP();
+    "pop  r31                 \n\t"
+    "pop  r30                 \n\t"
+    "pop  r19                 \n\t"
+    "pop  r18                 \n\t"
+    "pop  r0                  \n\t"
+    "out  __SREG__, r0        \n\t"
+    "pop  r0                  \n\t"
+    "reti                     \n\t"
+    :
+    : [ptr]     "i" (&nakedScan.rowPtr),
+      [frame]   "i" (&nakedScan.frame),
+      [row]     "i" (&nakedScan.row),
+      [color]   "I" (_SFR_IO_ADDR(HUB75_COLOR_PORT)),
+      [ctl]     "I" (_SFR_IO_ADDR(HUB75_CTL_PORT)),
+      [ctlpins] "I" (_SFR_IO_ADDR(HUB75_CTL_PINS)),
+      [clk]     "M" (bit(PIN_CLK)),
+      [oe]      "I" (PIN_OE),
+      [lat]     "I" (PIN_LAT),
+      [portrd]  "I" (_SFR_IO_ADDR(PORT_RD)),
+      [rd]      "I" (PIN_RD),
+      [cols]    "n" (SHIFTCOLS),
+      [rowmask] "M" (SCANROWS - 1)
+  );
+}
+#endif
+
+/********************************************************
+* getScanRow()
+*********************************************************
+* Where update() is on the panel: the buffer row it will
+* shift out next, which is also the row being lit now
+* plus one.  Rows update() has just gone past are the
+* safest ones to change.  When update() shifts out a whole
+* frame per call, the sketch only ever runs between
+* frames, so this is always 0
+*
+* Returns
+*   uint8_t - buffer row, 0 to SCANROWS - 1
+********************************************************/
+uint8_t Uno_HUB75_Driver::getScanRow()
+{
+#if HUB75_NAKED_ISR
+  // the naked ISR keeps its own place
+  if (usingISR)
+  {
+    return (*(volatile uint8_t*)&nakedScan.row);
   }
-  
-  SETBIT_CTL(PIN_OE);
+#endif
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  return (scanRow);
+#else
+  return (0);
+#endif
+}
+
+/********************************************************
+* waitForRow()
+*********************************************************
+* Race the beam.  Wait until update() has shifted out
+* every bit-plane of buffer row 'row', so it won't be
+* shown again for most of a frame.  Change that row then,
+* and with HUB75_SINGLE_BUFFER it's never on the panel
+* half changed.  Changing rows in order, each after
+* waitForRow() for it, stays just behind update() for a
+* whole frame:
+*
+*   for (uint8_t row = 0; row < SCANROWS; ++row)
+*   {
+*     panel.waitForRow(row);
+*     ... draw in buffer row 'row' ...
+*   }
+*
+* Returns at once if update() is on the next row already.
+* When update() shifts out a whole frame per call, this is
+* the same as waitForFrame()
+*
+* Parameters:
+*   uint8_t row - buffer row, 0 to SCANROWS - 1
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::waitForRow(uint8_t row)
+{
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  uint8_t next = (row + 1) & (SCANROWS - 1);
+
+  while (this->getScanRow() != next)
+  {
+    if (!usingISR)
+    {
+      this->update();
+    }
+  }
+#else
+  (void)row;
+  this->waitForFrame();
+#endif
+}
+
+/********************************************************
+* waitForFrame()
+*********************************************************
+* Wait until update() has just finished a frame, which
+* leaves the most time to change rows, top to bottom,
+* before it gets to them again.  When update() shifts out a
+* whole frame per call and isn't called from the ISR, the
+* sketch can't be drawing during a frame, so there's
+* nothing to wait for
+*
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::waitForFrame()
+{
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  this->waitForRow(SCANROWS - 1);
+#else
+  if (usingISR)
+  {
+    uint8_t frames = scanFrames;
+
+    while (scanFrames == frames)
+    {
+      // the ISR is shifting out frames
+    }
+  }
+#endif
 }
 
 /********************************************************
@@ -493,12 +2371,12 @@ void Uno_HUB75_Driver::update()
 ********************************************************/
 void Uno_HUB75_Driver::begin(bool useISR, void(*xlater)(int16_t& x, int16_t& y))
 {
-  // set up I/O pins
-  for (uint8_t ii = 2; ii < 14; ++ii)
-  {
-    pinMode(ii, OUTPUT);
-    digitalWrite(ii, LOW);
-  }
+  // set up I/O pins: the color lines low, leaving the other 2
+  // pins of their port alone, and the control lines as outputs
+  HUB75_COLOR_PORT &= 0x03;
+  HUB75_COLOR_DDR |= 0xfc;
+  HUB75_CTL_DDR |= bit(PIN_RA) | bit(PIN_RB) | bit(PIN_RC) |
+                   bit(PIN_CLK) | bit(PIN_LAT) | bit(PIN_OE);
 
   // clear the control lines
   SETBIT_CTL(PIN_OE);   // Output enable is active low
@@ -507,32 +2385,100 @@ void Uno_HUB75_Driver::begin(bool useISR, void(*xlater)(int16_t& x, int16_t& y))
   CLRBIT_CTL(PIN_RA);
   CLRBIT_CTL(PIN_RB);
   CLRBIT_CTL(PIN_RC);
+#if SCANROWS > 8
+  DDR_RD |= bit(PIN_RD);
+  CLRBIT_RD();
+#endif
+
+  // start with the buffers in their usual places
+  pixBuff = frameBuff[0];
+  updBuff = frameBuff[FRAMEBUFFS - 1];
+#if HUB75_PAGE_FLIP
+  pendingFlip = false;
+  syncRows = 0;
+#endif
 
   // clear pixel buffer
   this->clear();
 
   // clear the update buffer
-  memset(updBuff, 0x00, HALFROW * COLS);
+  memset(updBuff, 0x00, PLANES * SCANROWS * ROWBYTES);
+  dirtyRows = 0;
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  scanRow = 0;
+  scanPlane = 0;
+#else
+  scanFrames = 0;
+#endif
+
+#if HUB75_NAKED_ISR
+  nakedScan.frame = updBuff[0];
+  nakedScan.rowPtr = updBuff[0];
+  nakedScan.row = 0;
+#endif
+
+#if HUB75_STATS
+  memset(&counts, 0, sizeof(counts));
+#endif
+
+#if HUB75_STREAM
+  streaming = false;
+#endif
+
+#if HUB75_LAYERS
+  background = NULL;
+#endif
+
+#if HUB75_DISPLAY_LIST
+  clipRows = ALLROWS;
+#endif
 
   // tranlation function
   xlatFunc = xlater;
 
+  // original font for drawText()
+  font = &hub75Font5x7;
+
+  // full brightness; setBrightness() turns on compare B
+  brightness = 255;
+
+#if HUB75_VIRTUAL_COLS
+  viewX = 0;
+  viewY = 0;
+  frameX = 0;
+  frameY = 0;
+#endif
+
   // using ISR for timing??
   if (useISR)
   {
     usingISR = true;
 
-    TCCR2A = 0;
-    bitSet(TCCR2A, WGM21);  // WGM mode CTC, auto reset
+    HUB75_TCCRA = HUB75_CTC_A;  // WGM mode CTC, auto reset
     
+#if HUB75_BCM_BITS
+    // 4 us per tick (prescaler = 64); update() reloads the
+    // count for every bit-plane
+    HUB75_OCRA = HUB75_BCM_BASE - 1;
+    HUB75_TCCRB = HUB75_CTC_B | HUB75_DIV64;
+#elif HUB75_SCANLINE_ISR
+    // One row per interrupt, so 1/SCANROWS of the full frame
+    // period: prescaler = 64, count = 63, 252 us per row, and
+    // 2.016 ms per frame for 1/8 scan, same as below.  The
+    // count is 126 for 1/4 scan and 31 for 1/16
+    HUB75_OCRA = (63 * 8 / SCANROWS) - 1;
+    HUB75_TCCRB = HUB75_CTC_B | HUB75_DIV64;
+#else
     // For a time period of 2ms (500Hz):
     // prescaler = 256, count = 125
     // error = 0.0%
-    OCR2A = 125;
-    TCCR2B = bit(CS22) | bit(CS21);
+    HUB75_OCRA = 125;
+    HUB75_TCCRB = HUB75_CTC_B | HUB75_DIV256;
+#endif
     
     // enable interrupt on A
-    TIMSK2 = bit(OCIE2A);  
+    HUB75_TIMSK = bit(HUB75_OCIEA);  
   }
   else
   {
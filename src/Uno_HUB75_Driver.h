@@ -12,7 +12,7 @@
  * 
  * This library displays 3-bit colors (8 colors) using a
  * double buffered framebuffer to prevent flickering.  
- * Ideally, it will be using hardware timer 2 for updates,
+ * Ideally, it will be using hardware timer 2 (3 on a 32U4) for updates,
  * but can optionally be updated in the caller's main
  * loop.
 **********************************************************/
@@ -26,14 +26,102 @@
 #endif
 
 #include "Arduino.h"
+#include "Uno_HUB75_Config.h"
+#include "Uno_HUB75_Ports.h"
 
-// This is for the a 32x16 HUB75 display
-#define COLS 32
-#define ROWS 16
+// This is for HUB75_PANEL_COLS x HUB75_PANEL_ROWS (32x16 by default)
+// HUB75 displays, HUB75_CHAIN of them chained
+// together in HUB75_CHAIN_ROWS rows.  COLS and ROWS are the size of
+// the whole sign.  The default is just one panel
+#define CHAINCOLS (HUB75_CHAIN / HUB75_CHAIN_ROWS)
+#define COLS (HUB75_PANEL_COLS * CHAINCOLS)
+#define ROWS (HUB75_PANEL_ROWS * HUB75_CHAIN_ROWS)
 
 #define MAXCOLS (COLS - 1)
 #define MAXROWS (ROWS - 1)
-#define HALFROW (ROWS / 2)
+
+// Rows in each half of one panel, and how many row addresses it has,
+// which is also how many rows the framebuffers have.  With fewer
+// addresses than rows in a half (1/4 scan outdoor panels), each
+// address shifts SCANFOLD rows' worth of columns.  Every panel in the
+// chain is shifted at once, so SHIFTCOLS columns are shifted for each
+// row.  That's also how wide each framebuffer row is, unless
+// HUB75_VIRTUAL_COLS makes them wider
+#define HALFROW   (HUB75_PANEL_ROWS / 2)
+#define SCANROWS  HUB75_SCAN
+#define SCANFOLD  (HALFROW / SCANROWS)
+#define SHIFTCOLS (HUB75_PANEL_COLS * SCANFOLD * HUB75_CHAIN)
+
+#if HUB75_VIRTUAL_COLS
+#define BUFFCOLS  HUB75_VIRTUAL_COLS
+#else
+#define BUFFCOLS  SHIFTCOLS
+#endif
+
+// bytes in each framebuffer row; with HUB75_BITPLANE, 6 color lines
+// of LINEBYTES, each holding one bit of each column
+#if HUB75_BITPLANE
+#define LINEBYTES (BUFFCOLS / 8)
+#define ROWBYTES  (6 * LINEBYTES)
+#else
+#define ROWBYTES  BUFFCOLS
+#endif
+
+// the framebuffer is laid out like the panel (not scrambled by a
+// 1/4 scan), so rectangles on the panel are rectangles in it
+#define HUB75_LINEAR  (SCANFOLD == 1)
+
+// size of the panel as the drawing methods see it; the same as
+// COLS and ROWS unless HUB75_TRANSFORM turns it on its side, or
+// the framebuffers are wider than the panel
+#if HUB75_TRANSFORM == HUB75_XFORM_ROT90 || HUB75_TRANSFORM == HUB75_XFORM_ROT270
+#define WIDTH   ROWS
+#define HEIGHT  COLS
+#elif HUB75_VIRTUAL_COLS
+#define WIDTH   HUB75_VIRTUAL_COLS
+#define HEIGHT  ROWS
+#else
+#define WIDTH   COLS
+#define HEIGHT  ROWS
+#endif
+
+#define MAXX    (WIDTH - 1)
+#define MAXY    (HEIGHT - 1)
+
+// number of bit-planes in each framebuffer, and the highest
+// brightness level of a single channel
+#if HUB75_BCM_BITS
+#define PLANES    HUB75_BCM_BITS
+#else
+#define PLANES    1
+#endif
+#define MAXLEVEL  ((1 << PLANES) - 1)
+
+// one bit per buffer row (a row address) for dirty row masks
+#define ALLROWS   ((Uno_HUB75_Driver::RowMask)((1UL << SCANROWS) - 1))
+
+// number of framebuffers; one with HUB75_SINGLE_BUFFER
+#if HUB75_SINGLE_BUFFER
+#define FRAMEBUFFS 1
+#else
+#define FRAMEBUFFS 2
+#endif
+
+// the framebuffers have to fit with room to spare for the sketch
+#if FRAMEBUFFS * PLANES * SCANROWS * ROWBYTES > HUB75_BUFF_RAM
+#error The framebuffers need more RAM than this board has; use fewer panels or bit-planes
+#endif
+
+// Streaming wire format (HUB75_STREAM).  Data bytes are framebuffer
+// bytes, which never have the low 2 bits set, so anything that does
+// is one of these.  A frame is FRAME and every byte of the buffer,
+// bit-plane by bit-plane and row by row, or ROW and the BUFFCOLS
+// bytes of one buffer row for each row that changed; then COMMIT.
+// The panel sends ACK back when the frame is shown
+#define HUB75_STREAM_FRAME    0x01
+#define HUB75_STREAM_ROW      0x02      // | buffer row << 2
+#define HUB75_STREAM_COMMIT   0x03
+#define HUB75_STREAM_ACK      0x06
 
 // main class for this library
 class Uno_HUB75_Driver
@@ -68,21 +156,196 @@ public:
     int16_t y2;
   } Rect;
 
-  Uno_HUB75_Driver() {}
+#if HUB75_BCM_BITS
+  // a pixel's value in every bit-plane; 3 bits (R, G, B) per plane
+  // with plane 0 in the lowest bits
+  typedef uint16_t Pixel;
+#else
+  typedef uint8_t Pixel;
+#endif
+
+  // A bitmap font, kept in FLASH (PROGMEM) like the font data
+  // itself.  Each glyph is 'cols' columns of (height + 7) / 8
+  // bytes, with bit 0 of the first byte the top pixel.  For a
+  // proportional font, 'spans' has a byte per glyph: blank columns
+  // to skip << 4 | width.  See font.h
+  typedef struct
+  {
+    const uint8_t* bitmap;    // glyph columns, in PROGMEM
+    const uint8_t* spans;     // per glyph, in PROGMEM; NULL for fixed width
+    uint8_t first;            // first character in the font
+    uint8_t last;             // last character in the font
+    uint8_t cols;             // columns stored for each glyph
+    uint8_t height;           // rows, 1 to 16
+    uint8_t spacing;          // blank columns after each glyph
+  } Font;
+
+  // pixel formats of a Sprite
+  enum SpriteFormat
+  {
+    SPRITE_1BPP = 1,          // 1 bit a pixel, set bits drawn in one color
+    SPRITE_3BPP = 3           // a Colors value a pixel, 2 pixels a byte
+  };
+
+  // A bitmap kept in FLASH (PROGMEM), with one or more frames of
+  // the same size one after the other.  Each row of a frame is
+  // (width + 7) / 8 bytes for SPRITE_1BPP, leftmost pixel in the
+  // top bit, or (width + 1) / 2 bytes for SPRITE_3BPP, leftmost
+  // pixel in the high nibble.  3bpp pixels equal to 'key' aren't
+  // drawn; extras/tools/img2sprite.py makes these from images
+  typedef struct
+  {
+    const uint8_t* bitmap;    // frames of rows, top row first, in PROGMEM
+    uint8_t width;            // pixels
+    uint8_t height;           // rows
+    uint8_t frames;           // frames in the bitmap
+    uint8_t format;           // SPRITE_1BPP or SPRITE_3BPP
+    uint8_t key;              // SPRITE_3BPP transparent value; 8 for none of the colors
+  } Sprite;
+
+  // A canned animation in FLASH (PROGMEM), packed for one build's
+  // framebuffer by extras/tools/img2anim.py.  Each frame is a
+  // delay, a bit for each buffer row that changed since the frame
+  // before, and those rows, run-length coded; see
+  // Uno_HUB75_Anim.cpp.  Frame 0 has every row
+  typedef struct
+  {
+    const uint8_t* data;      // the frames one after another, in PROGMEM
+    const uint16_t* index;    // where each frame starts in 'data', in PROGMEM
+    uint16_t frames;          // frames in the animation
+    uint16_t cols;            // BUFFCOLS it was packed for; up to 256
+    uint8_t rows;             // PLANES * SCANROWS it was packed for
+  } Animation;
+
+  // what getStats() returns.  Ticks are HUB75 timer ticks, counted
+  // from the compare match that started the ISR
+  typedef struct
+  {
+    uint32_t frames;          // times the whole panel was refreshed
+    uint32_t flips;           // draw()s that made it to the panel
+    uint32_t updates;         // calls to update()
+    uint8_t  maxTicks;        // longest update()
+    uint8_t  avgTicks;        // average update()
+    uint8_t  usPerTick;       // microseconds per tick
+    uint8_t  loadPercent;     // share of the CPU used by update()
+    uint16_t late;            // update()s that started over 1/4 period late
+    uint16_t overlaps;        // update()s still running at the next match
+  } Stats;
+
+  // one bit per buffer row
+#if SCANROWS > 8
+  typedef uint16_t RowMask;
+#else
+  typedef uint8_t RowMask;
+#endif
+
+  Uno_HUB75_Driver() : pixBuff(frameBuff[0]), updBuff(frameBuff[FRAMEBUFFS - 1]) {}
   ~Uno_HUB75_Driver() {}
 
   void begin(bool useISR = true, void(*xlater)(int16_t& x, int16_t& y) = NULL);
   
-  void draw();
+  // false if a page flip was still pending, so the frame was dropped
+  bool draw();
   void update();
 
+#if HUB75_PAGE_FLIP
+  // true from draw() until update() has swapped the framebuffers
+  bool flipPending();
+#endif
+
+  // the buffer row update() will shift out next; always 0 when it
+  // does a whole frame per call
+  uint8_t getScanRow();
+
+  // wait until update() has just shifted out buffer row 'row', or
+  // the last row of a frame, so there's most of a frame to change
+  // it before it's shown again.  Calls update() when not using the
+  // ISR.  For HUB75_SINGLE_BUFFER, to change rows without tearing
+  void waitForRow(uint8_t row);
+  void waitForFrame();
+
+  // copy the counters (HUB75_STATS) to 's', optionally starting
+  // them over.  All zeros when HUB75_STATS is off
+#if HUB75_STATS
+  void getStats(Uno_HUB75_Driver::Stats& s, bool reset = false);
+#else
+  void getStats(Uno_HUB75_Driver::Stats& s, bool reset = false)
+        { (void)reset; memset(&s, 0, sizeof(s)); }
+#endif
+
+#if HUB75_STREAM
+  // take frames from the serial port, 8N1 at 'baud', instead of
+  // from drawing.  Don't draw or use Serial meanwhile
+  void beginStream(uint32_t baud = 500000);
+  void endStream();
+
+  // bytes lost or bad, and packets cut short, since beginStream()
+  uint16_t streamErrors() { return (streamErrs); }
+
+  // for the USART receive and transmit complete ISRs only; the
+  // library's, or the sketch's with HUB75_STREAM_ISR set to 0
+  void streamRx();
+  void streamTx();
+#endif
+
+#if HUB75_DISPLAY_LIST
+  // only draw on the buffer rows set in 'rows' (ALLROWS, all of
+  // them, after begin()).  Applies to the drawing methods,
+  // copyRegion(), scrollRegion() and drawAnimation(); not to
+  // clear(), fillAll() or streamed frames
+  void setClipRows(Uno_HUB75_Driver::RowMask rows) { clipRows = rows; }
+  Uno_HUB75_Driver::RowMask getClipRows() { return (clipRows); }
+
+  // buffer rows the pixels in a rectangle are in
+  Uno_HUB75_Driver::RowMask rectRows(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
+  // set the selected buffer rows to black
+  void clearRows(Uno_HUB75_Driver::RowMask rows);
+#endif
+
+#if HUB75_LAYERS
+  // show 'bg', a whole framebuffer (PLANES * SCANROWS * BUFFCOLS
+  // bytes) in RAM or in FLASH, wherever what's drawn is color
+  // 'key'.  NULL for no background.  Call again after changing a
+  // background in RAM
+  void setBackground(const uint8_t* bg, bool inFlash = false, Uno_HUB75_Driver::Colors key = BLACK);
+
+  // copy what's been drawn to 'bg', to use as a background
+  void saveBackground(uint8_t* bg);
+#endif
+
+  // panel brightness, 0 (off) to 255 (full, the default).  Call
+  // after begin()
+  void setBrightness(uint8_t level);
+  uint8_t getBrightness() { return (brightness); }
+
+  // rows drawn on since the last draw(); bit 'n' is buffer row 'n',
+  // which is every row lit by row address 'n'.  Zero means there's
+  // nothing new to draw()
+  Uno_HUB75_Driver::RowMask getDirtyRows() { return (dirtyRows); }
+
+#if HUB75_VIRTUAL_COLS
+  // show the part of the framebuffer starting at column 'x', with
+  // the rows rolled up by 'y'.  Both wrap around, and update()
+  // picks them up at the start of the next frame
+  void setViewport(int16_t x, int16_t y);
+#endif
+
   void clear();
   void fillAll(Uno_HUB75_Driver::Colors c);
+#if HUB75_BCM_BITS
+  // BCM only - fill with brightness levels of 0 to MAXLEVEL per channel
+  void fillAll(uint8_t r, uint8_t g, uint8_t b);
+#endif
 
   // polymorphic - pixel is defined by X/Y coordinates or a Point struct
   void setPixel(int16_t x, int16_t y, Uno_HUB75_Driver::Colors c);
   void setPixel(Uno_HUB75_Driver::Point& p, Uno_HUB75_Driver::Colors c)
         { setPixel(p.x, p.y, c); }
+#if HUB75_BCM_BITS
+  // BCM only - set a pixel by brightness levels of 0 to MAXLEVEL per channel
+  void setPixel(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
+#endif
 
   // polymorphic - line is defined by a pair of X/Y coordinates or Point structs
   void line(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Colors c);
@@ -113,6 +376,19 @@ public:
   void outlineBox(Uno_HUB75_Driver::Rect& rect, Uno_HUB75_Driver::Colors c)
         { rectangle(rect.x1, rect.y1, rect.x2, rect.y2, c, false); }
 
+  // circles and ellipses by their center and radius, optionally filled
+  void circle(int16_t x, int16_t y, int16_t r, Uno_HUB75_Driver::Colors c, bool fill = true);
+  void circle(Uno_HUB75_Driver::Point& center, int16_t r, Uno_HUB75_Driver::Colors c, bool fill = true)
+        { circle(center.x, center.y, r, c, fill); }
+  void ellipse(int16_t x, int16_t y, int16_t rx, int16_t ry, Uno_HUB75_Driver::Colors c, bool fill = true);
+
+  // triangles and polygons by their corners, optionally filled.  Only
+  // convex polygons (no corner pointing in) fill properly
+  void triangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, Uno_HUB75_Driver::Colors c, bool fill = true);
+  void triangle(Uno_HUB75_Driver::Point& p1, Uno_HUB75_Driver::Point& p2, Uno_HUB75_Driver::Point& p3, Uno_HUB75_Driver::Colors c, bool fill = true)
+        { triangle(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, c, fill); }
+  void polygon(const Uno_HUB75_Driver::Point* pts, uint8_t n, Uno_HUB75_Driver::Colors c, bool fill = true);
+
   // polymorphic - copy a pixel from one location to another
   void copyPixel(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
   void copyPixel(Uno_HUB75_Driver::Point& src, Uno_HUB75_Driver::Point& dst)
@@ -122,19 +398,142 @@ public:
   // the parameter list is unwieldy
   void copyRegion(Uno_HUB75_Driver::Rect& src, Uno_HUB75_Driver::Rect& dst);
 
-  // text methods
+  // move what's in a rectangle by dx/dy, filling in what it uncovers
+  void scrollRegion(Uno_HUB75_Driver::Rect& r, int16_t dx, int16_t dy, Uno_HUB75_Driver::Colors fill = BLACK);
+
+  // text methods, always in the original 5x7 font, 6 pixels apart
   void drawChar(int16_t x, int16_t y, char chr, Uno_HUB75_Driver::Colors c);
   void drawString(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c);
 
+  // text in the font picked by setFont() (hub75Font5x7 by default).
+  // The string can be in RAM, F("...") or PSTR("...").  They all
+  // return the width of the text in pixels
+  void setFont(const Uno_HUB75_Driver::Font* f) { font = f; }
+  const Uno_HUB75_Driver::Font* getFont() { return (font); }
+  int16_t drawText(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c);
+  int16_t drawText(int16_t x, int16_t y, const __FlashStringHelper* str, Uno_HUB75_Driver::Colors c)
+        { return (drawText_P(x, y, (PGM_P)str, c)); }
+  int16_t drawText_P(int16_t x, int16_t y, PGM_P str, Uno_HUB75_Driver::Colors c);
+
+  // measure text in the current font without drawing it
+  int16_t textWidth(const char* str);
+  int16_t textWidth(const __FlashStringHelper* str)
+        { return (textWidth_P((PGM_P)str)); }
+  int16_t textWidth_P(PGM_P str);
+
+  // draw frame 'frame' (counting on past the last frame wraps
+  // around) of a sprite in PROGMEM with its top left pixel at X/Y,
+  // and its rows going toward lower Y like text.  'c' is the color
+  // of a SPRITE_1BPP sprite; the clear bits aren't drawn
+  void drawSprite(int16_t x, int16_t y, const Uno_HUB75_Driver::Sprite* sprite, uint8_t frame = 0, Uno_HUB75_Driver::Colors c = WHITE);
+
+  // unpack frame 'frame' of an animation in PROGMEM into the
+  // framebuffer and draw() it; 'frame' moves on to the next one,
+  // back to 0 after the last.  Returns how long to show it, in ms,
+  // or 0 if the animation was packed for a different build
+  uint16_t drawAnimation(const Uno_HUB75_Driver::Animation* anim, uint16_t& frame);
+
   // return the color of the selected pixel
   Uno_HUB75_Driver::Colors getPixel(int16_t x, int16_t y);
 
+  // convert members of the Colors enum and RGB levels to a Pixel
+  static Uno_HUB75_Driver::Pixel toPixel(Uno_HUB75_Driver::Colors c);
+#if HUB75_BCM_BITS
+  static Uno_HUB75_Driver::Pixel toPixel(uint8_t r, uint8_t g, uint8_t b);
+#endif
+
 private:
-  // double-buffered to prevent flickering
-  uint8_t pixBuff[HALFROW][COLS];         // "drawing" framebuffer
-  uint8_t updBuff[HALFROW][COLS];         // "output" framebuffer
+  // double-buffered to prevent flickering, unless HUB75_SINGLE_BUFFER,
+  // when both pointers are to the one buffer.  In BCM mode each buffer
+  // holds PLANES bit-planes one after the other, so bit-plane 'p'
+  // of row 'r' is at [p * SCANROWS + r]
+  uint8_t frameBuff[FRAMEBUFFS][PLANES * SCANROWS][ROWBYTES];
+  uint8_t (*pixBuff)[ROWBYTES];           // "drawing" framebuffer
+  uint8_t (*updBuff)[ROWBYTES];           // "output" framebuffer
   bool usingISR;
 
+  // rows changed since the last draw(), one bit per buffer row
+  Uno_HUB75_Driver::RowMask dirtyRows;
+
+#if HUB75_PAGE_FLIP
+  // set by draw(), cleared by update() when it swaps buffers
+  volatile bool pendingFlip;
+
+  // rows that changed in the frame last flipped; they are copied
+  // to the new drawing buffer after the flip
+  Uno_HUB75_Driver::RowMask syncRows;
+#endif
+
+#if HUB75_BCM_BITS || HUB75_SCANLINE_ISR
+  // the next row (and bit-plane, in BCM mode) update() will shift out
+  volatile uint8_t scanRow;
+  uint8_t scanPlane;
+#else
+  // counts the frames update() has shifted out, for waitForFrame()
+  volatile uint8_t scanFrames;
+#endif
+
+  // from setBrightness()
+  uint8_t brightness;
+
+#if HUB75_VIRTUAL_COLS
+  // viewport set by setViewport(), and the one update() is using
+  // for this frame
+  volatile uint8_t viewX;
+  volatile uint8_t viewY;
+  uint8_t frameX;
+  uint8_t frameY;
+#endif
+
+#if HUB75_DISPLAY_LIST
+  // from setClipRows()
+  Uno_HUB75_Driver::RowMask clipRows;
+#endif
+
+#if HUB75_LAYERS
+  // from setBackground()
+  const uint8_t* background;
+  bool bgInFlash;
+  uint8_t bgKey;
+#endif
+
+#if HUB75_STREAM
+  // bytes that came while a frame was waiting to be shown; added at
+  // the head by the receive ISR, taken from the tail
+  uint8_t streamRing[HUB75_STREAM_RING];
+  volatile uint8_t streamHead;
+  volatile uint8_t streamTail;
+
+  // true while bytes from the ring are being put in the buffer
+  volatile bool streamBusy;
+  bool streaming;
+
+  // where the next data byte goes, as an offset in the drawing
+  // buffer, and the end of the packet
+  uint16_t streamPos;
+  uint16_t streamEnd;
+  uint16_t streamErrs;
+#endif
+
+#if HUB75_STATS
+  // running totals for getStats(); busy and period are in ticks
+  struct
+  {
+    uint32_t frames;
+    uint32_t flips;
+    uint32_t updates;
+    uint32_t busy;
+    uint32_t period;
+    uint8_t  maxTicks;
+    uint8_t  entryTicks;
+    uint16_t late;
+    uint16_t overlaps;
+  } counts;
+#endif
+
+  // font for drawText(), in PROGMEM
+  const Uno_HUB75_Driver::Font* font;
+
   // pointer to the translator method provided by begin().  If none
   // provided, begin() will set this to NULL
   void (*xlatFunc)(int16_t& x, int16_t& y);
@@ -142,6 +541,93 @@ private:
   // internal method to set the display buffer.  Does all sanity checking, 
   // so all drawing should come down to this instead of directly writing to
   // any buffer
-  void setBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Colors c);
+  void setBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c);
+
+  // setBuff() without the translation method or any checking;
+  // defined in Uno_HUB75_Driver_impl.h
+  void putBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c);
+  Uno_HUB75_Driver::Pixel getBuff(int16_t x, int16_t y);
+
+  // copy a rectangle, or one row of it, that may overlap the
+  // destination
+  void moveRegion(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t w, int16_t h);
+  void moveRow(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t w, int8_t dir, bool both);
+
+  // copy some of the rows from one framebuffer to another
+  void copyRows(uint8_t (*dst)[ROWBYTES], uint8_t (*src)[ROWBYTES], Uno_HUB75_Driver::RowMask rows, bool blockISR);
+#if HUB75_LAYERS
+  void mergeRows(Uno_HUB75_Driver::RowMask rows, bool blockISR);
+#endif
+
+  // swap buffers if draw() asked for it; update() calls this at the
+  // start of each frame
+  void flip();
+
+  // Cohen-Sutherland outcode for clipping lines to the panel
+  static uint8_t outcode(int16_t x, int16_t y);
+
+#if HUB75_BITPLANE
+  // draw one row of a 1bpp sprite a byte at a time; false if it
+  // can't be done that way
+  bool blitBits(int16_t x, int16_t y, const uint8_t* src, uint8_t pos, uint8_t n, Uno_HUB75_Driver::Colors c);
+#endif
+
+  // setBuff() for pixels that may be off the panel
+  void plot(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c);
+
+  // set a whole bit-plane of the drawing buffer to one color code
+  void fillPlane(uint8_t plane, uint8_t code);
+
+  // fill a rectangle a buffer row at a time
+  void spanFill(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Pixel c);
+  void fillBuffRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, Uno_HUB75_Driver::Pixel c);
+
+  // draw or measure a string, in RAM or PROGMEM
+  int16_t textRun(int16_t x, int16_t y, const char* str, bool inFlash, Uno_HUB75_Driver::Colors c, bool draw);
+
+  // draw one character of a font; returns its width
+  uint8_t drawGlyph(const Uno_HUB75_Driver::Font& f, int16_t x, int16_t y, uint8_t chr, Uno_HUB75_Driver::Pixel c);
+
+  // shift one row of color data into the panel and latch it
+  void shiftRow(const uint8_t* row);
+  void latchRow(uint8_t thisRow);
+
+  // set when the HUB75 timer turns the row just latched off again
+  void dimRow();
+
+  // what update() does at the start of a frame, and the row of
+  // the output buffer it shifts out for a row address
+  void startFrame();
+  void shiftBuffRow(uint8_t plane, uint8_t row);
+
+#if HUB75_STREAM
+  // one byte of the stream, and catching up on the ring
+  void streamByte(uint8_t b);
+  void streamDrain();
+#endif
+
+  // timing for getStats(), at the start and end of update()
+  void statsEnter();
+  void statsLeave();
+#if HUB75_VIRTUAL_COLS
+  static void shiftCols(const uint8_t* cols, uint16_t count, bool swap);
+#endif
 };
+// fonts for setFont(): the original 5x7 font, the same with
+// proportional spacing, and a small 3x5 one
+extern const Uno_HUB75_Driver::Font hub75Font5x7 PROGMEM;
+extern const Uno_HUB75_Driver::Font hub75Font5x7Prop PROGMEM;
+extern const Uno_HUB75_Driver::Font hub75Font3x5 PROGMEM;
+
+#if !HUB75_LINEAR
+// Where a pixel of one panel goes in a 1/4 scan panel's shift
+// registers.  Called with the column (0 to HUB75_PANEL_COLS - 1) and
+// the row in the panel's top or bottom half (0 to HALFROW - 1); it has
+// to change them to the place in the shift registers (0 to
+// HUB75_PANEL_COLS * SCANFOLD - 1) and the row address (0 to
+// SCANROWS - 1).  The library's is weak, so a sketch can replace it
+// by defining its own.
+void hub75ScanMap(int16_t& x, int16_t& y);
+#endif
+
 #endif // PANEL_H_
\ No newline at end of file
@@ -12,19 +12,21 @@
  * 
  * This library displays 3-bit colors (8 colors) using a
  * double buffered framebuffer to prevent flickering.  
- * Ideally, it will be using hardware timer 2 for updates,
+ * Ideally, it will be using hardware timer 2 (3 on a 32U4) for updates,
  * but can optionally be updated in the caller's main
  * loop.
 **********************************************************/
 #ifndef PANEL_IMPL_H_
 #define PANEL_IMPL_H_
 
+#include "Uno_HUB75_Driver.h"
+
 #ifndef SETBIT_CTL
-#define SETBIT_CTL(a)  (PORTB |= bit(a))
+#define SETBIT_CTL(a)  (HUB75_CTL_PORT |= bit(a))
 #endif
 
 #ifndef CLRBIT_CTL
-#define CLRBIT_CTL(a)  (PORTB &= ~bit(a))
+#define CLRBIT_CTL(a)  (HUB75_CTL_PORT &= ~bit(a))
 #endif
 
 #ifndef _NOP
@@ -32,13 +34,16 @@
 #endif
 
 // Some definitions for I/O in terms of AVR register
-// defined names, not Arduino pin numbers
-#define PORT_RF PORTD
-#define PORT_GF PORTD
-#define PORT_BF PORTD
-#define PORT_RS PORTD
-#define PORT_GS PORTD
-#define PORT_BS PORTD
+// defined names, not Arduino pin numbers.  The ports and
+// the control pins depend on the board; see
+// Uno_HUB75_Ports.h.  The color pins are the framebuffer
+// bits, so they're the same on every board
+#define PORT_RF HUB75_COLOR_PORT
+#define PORT_GF HUB75_COLOR_PORT
+#define PORT_BF HUB75_COLOR_PORT
+#define PORT_RS HUB75_COLOR_PORT
+#define PORT_GS HUB75_COLOR_PORT
+#define PORT_BS HUB75_COLOR_PORT
 #define PIN_RF  2
 #define PIN_GF  3
 #define PIN_BF  4
@@ -46,18 +51,315 @@
 #define PIN_GS  6
 #define PIN_BS  7
 
-#define PORT_RA PORTB
-#define PORT_RB PORTB
-#define PORT_RC PORTB
-#define PIN_RA  0
-#define PIN_RB  1
-#define PIN_RC  2
-
-#define PORT_CLK  PORTB
-#define PORT_LAT  PORTB
-#define PORT_OE   PORTB
-#define PIN_CLK   3
-#define PIN_LAT   4
-#define PIN_OE    5
+#define PORT_RA HUB75_CTL_PORT
+#define PORT_RB HUB75_CTL_PORT
+#define PORT_RC HUB75_CTL_PORT
+
+// row 'D' for 1/16 scan panels
+#define SETBIT_RD()   (PORT_RD |= bit(PIN_RD))
+#define CLRBIT_RD()   (PORT_RD &= ~bit(PIN_RD))
+
+#define PORT_CLK  HUB75_CTL_PORT
+#define PORT_LAT  HUB75_CTL_PORT
+#define PORT_OE   HUB75_CTL_PORT
+
+// A row of pixels on the panel is a run of bytes in one buffer row,
+// one after the other (going one way or the other).  Not so when
+// turned on its side, or with the columns scrambled by a 1/4 scan.
+// With HUB75_BITPLANE it's a run of bits in each color line instead
+#define PANEL_RUNS    (HUB75_LINEAR &&                              \
+                       HUB75_TRANSFORM != HUB75_XFORM_ROT90 &&      \
+                       HUB75_TRANSFORM != HUB75_XFORM_ROT270)
+#define PIXEL_RUNS    (PANEL_RUNS && !HUB75_BITPLANE)
+#define BIT_RUNS      (PANEL_RUNS && HUB75_BITPLANE)
+
+/********************************************************
+* xform()
+*********************************************************
+* The compile-time coordinate transform (HUB75_TRANSFORM).
+* Turns panel coordinates as the sketch sees them into
+* buffer coordinates.  It's resolved by the preprocessor,
+* so for HUB75_XFORM_NONE it compiles to nothing, and the
+* others fold into the address math of the caller
+*
+* Parameters:
+*   int16_t& x - the X coordinate
+*   int16_t& y - the Y coordinate
+* Returns
+*   void
+********************************************************/
+static inline void xform(int16_t& x, int16_t& y)
+{
+#if HUB75_TRANSFORM == HUB75_XFORM_ROT90
+  // quarter turn clockwise; origin at the top right of the panel
+  int16_t t = x;
+  x = MAXCOLS - y;
+  y = t;
+#elif HUB75_TRANSFORM == HUB75_XFORM_ROT180
+  // origin at the bottom right
+  x = MAXCOLS - x;
+  y = MAXROWS - y;
+#elif HUB75_TRANSFORM == HUB75_XFORM_ROT270
+  // quarter turn counter clockwise; origin at the bottom left
+  int16_t t = x;
+  x = y;
+  y = MAXROWS - t;
+#elif HUB75_TRANSFORM == HUB75_XFORM_MIRROR_X
+  // origin at the top right, X runs right to left
+  x = MAXCOLS - x;
+#elif HUB75_TRANSFORM == HUB75_XFORM_MIRROR_Y
+  // origin at the bottom left, Y runs upward
+  y = MAXROWS - y;
+#else
+  (void)x;
+  (void)y;
+#endif
+}
+
+/********************************************************
+* chainMap()
+*********************************************************
+* Find where a pixel of the whole sign is in the buffer.
+*
+* The first column of the buffer is shifted out first, so
+* it ends up in the panel at the far end of the chain.
+* Seen from the front, the Arduino feeds the top right
+* panel, and the chain runs right to left along the top
+* row of panels.  After that:
+*   - every row of panels runs right to left the same way,
+*     or
+*   - with HUB75_SERPENTINE, the chain snakes back and
+*     forth, and every other row of panels is mounted
+*     upside down and runs left to right
+*
+* With only one row of panels this compiles to nothing
+*
+* Parameters:
+*   int16_t& x - the X coordinate
+*   int16_t& y - the Y coordinate
+* Returns
+*   void
+********************************************************/
+static inline void chainMap(int16_t& x, int16_t& y)
+{
+#if HUB75_CHAIN_ROWS > 1
+  int16_t band = y / HUB75_PANEL_ROWS;
+  y -= band * HUB75_PANEL_ROWS;
+
+#if HUB75_SERPENTINE
+  if (band & 0x01)
+  {
+    // upside down panels, chained left to right
+    x = (HUB75_CHAIN - band * CHAINCOLS) * HUB75_PANEL_COLS - 1 - x;
+    y = HUB75_PANEL_ROWS - 1 - y;
+    return;
+  }
+#endif
+
+  x += (HUB75_CHAIN - (band + 1) * CHAINCOLS) * HUB75_PANEL_COLS;
+#else
+  (void)x;
+  (void)y;
+#endif
+}
+
+/********************************************************
+* scanMap()
+*********************************************************
+* Find where a pixel of a row of panels is in the buffer.
+* Row 'y' of the top half of a panel is in the low bits of
+* buffer row 'y', and row 'y' of the bottom half is in the
+* high bits of buffer row 'y - SCANROWS'; setBuff() takes
+* care of that part.
+*
+* For panels with one row address per row in each half,
+* that's all there is, and this compiles to nothing.  With
+* 1/4 scan panels each buffer row holds SCANFOLD rows of
+* each half, scrambled by hub75ScanMap()
+*
+* Parameters:
+*   int16_t& x - the X coordinate in the chain
+*   int16_t& y - the Y coordinate in the panel
+* Returns
+*   void
+********************************************************/
+static inline void scanMap(int16_t& x, int16_t& y)
+{
+#if !HUB75_LINEAR
+  int16_t panel = x / HUB75_PANEL_COLS;
+  int16_t half = (y < HALFROW) ? 0 : SCANROWS;
+
+  x -= panel * HUB75_PANEL_COLS;
+  y -= half ? HALFROW : 0;
+
+  hub75ScanMap(x, y);
+
+  x += panel * HUB75_PANEL_COLS * SCANFOLD;
+  y += half;
+#else
+  (void)x;
+  (void)y;
+#endif
+}
+
+/********************************************************
+* putBuff()
+*********************************************************
+* The part of setBuff() after the translation method; it
+* maps panel coordinates to the framebuffer and stores the
+* pixel.  Inline so that the drawing methods that have
+* already clipped to the panel (and know there is no
+* translation method) can write straight to the buffer.
+* No bounds checking!
+*
+* Paramters:
+*   int16_t x - the X coordinate, 0 to MAXX
+*   int16_t y - the Y coordinate, 0 to MAXY
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
+* Returns
+*   void
+********************************************************/
+inline void Uno_HUB75_Driver::putBuff(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c)
+{
+  // the compile-time transform, if any, then find the place in
+  // the chain of panels and in the panel's shift registers
+  xform(x, y);
+  chainMap(x, y);
+  scanMap(x, y);
+
+  // memory buffer is set up as [row][column], or 
+  // think of it as [Y][X].  Maybe backwards, but
+  // it makes looping through the drive more clean
+
+  // We're using 8 colors on the panel (black, red, green, blue,
+  // yellow, cyan, magenta).  That only takes 3 bits.  To save
+  // RAM on this small micro, we'll use the lower 4 bits of each
+  // buffer byte to be the "top" half of the physical display
+  // and the upper 4 bytes for the "bottom" half of the physical
+  // display
+  //
+  // In BCM mode the same thing is done once per bit-plane, each
+  // taking the next 3 bits of the Pixel value.  With
+  // HUB75_BITPLANE each of the 3 bits is one bit of a color line
+#if HUB75_DISPLAY_LIST
+  if (!(clipRows & bit(y & (SCANROWS - 1))))
+  {
+    return;
+  }
+#endif
+
+  dirtyRows |= bit(y & (SCANROWS - 1));
+
+#if HUB75_BITPLANE
+  // one bit in each of the 3 color lines of the half, the lowest
+  // bit of the color (red) in the first
+  uint8_t half = 0;
+  uint8_t mask = 0x80 >> (x & 0x07);
+
+  if (y >= SCANROWS)
+  {
+    y -= SCANROWS;
+    half = 3 * LINEBYTES;
+  }
+
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    uint8_t* line = &pixBuff[plane * SCANROWS + y][half + (x >> 3)];
+    uint8_t code = c & 0x07;
+    c >>= 3;
+
+    for (uint8_t ii = 0; ii < 3; ++ii, code >>= 1, line += LINEBYTES)
+    {
+      if (code & 0x01)
+      {
+        *line |= mask;
+      }
+      else
+      {
+        *line &= ~mask;
+      }
+    }
+  }
+#else
+  for (uint8_t plane = 0; plane < PLANES; ++plane)
+  {
+    uint8_t code = c & 0x07;
+    c >>= 3;
+
+    if (y < SCANROWS)
+    {
+      // mask off the top 3 bits (5, 6, and 7) and or it with the color (shifted left 2 bits)
+      uint8_t& buf = pixBuff[plane * SCANROWS + y][x];
+      buf = (uint8_t)(((buf & 0xe0) | (code << 2)) & 0xff);
+    }
+    else
+    {
+      // mask off bits 2, 3, and 4 (the color bits for the upper half), and or it with the
+      // 3 color bits for the upper half
+      uint8_t& buf = pixBuff[plane * SCANROWS + y - SCANROWS][x];
+      buf = (uint8_t)(((buf & 0x1c) | (code << 5)) & 0xff); 
+    }
+  }
+#endif
+}
+
+/********************************************************
+* getBuff()
+*********************************************************
+* The opposite of putBuff(); read a pixel's value in every
+* bit-plane.  No bounds checking!
+*
+* Parameters:
+*   int16_t x - the X coordinate, 0 to MAXX
+*   int16_t y - the Y coordinate, 0 to MAXY
+* Returns
+*   Uno_HUB75_Driver::Pixel - the color, as toPixel() makes it
+********************************************************/
+inline Uno_HUB75_Driver::Pixel Uno_HUB75_Driver::getBuff(int16_t x, int16_t y)
+{
+  xform(x, y);
+  chainMap(x, y);
+  scanMap(x, y);
+
+  // plane 0 ends up in the lowest bits
+  Uno_HUB75_Driver::Pixel c = 0;
+
+#if HUB75_BITPLANE
+  uint8_t half = 0;
+  uint8_t mask = 0x80 >> (x & 0x07);
+
+  if (y >= SCANROWS)
+  {
+    y -= SCANROWS;
+    half = 3 * LINEBYTES;
+  }
+
+  for (uint8_t plane = PLANES; plane-- > 0; )
+  {
+    // the last color line of the half (blue) first
+    const uint8_t* line = &pixBuff[plane * SCANROWS + y][half + 2 * LINEBYTES + (x >> 3)];
+
+    for (uint8_t ii = 0; ii < 3; ++ii, line -= LINEBYTES)
+    {
+      c = (c << 1) | ((*line & mask) ? 1 : 0);
+    }
+  }
+#else
+  uint8_t shift = 2;
+
+  if (y >= SCANROWS)
+  {
+    y -= SCANROWS;
+    shift = 5;
+  }
+
+  for (uint8_t plane = PLANES; plane-- > 0; )
+  {
+    c = (c << 3) | ((pixBuff[plane * SCANROWS + y][x] >> shift) & 0x07);
+  }
+#endif
+
+  return (c);
+}
 
 #endif // PANEL_IMPL_H_
\ No newline at end of file
@@ -0,0 +1,144 @@
+/**********************************************************
+ * @file    Uno_HUB75_Layer.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Background layer methods for the Uno_HUB75_Driver class
+ * (HUB75_LAYERS).
+ *
+ * The background is a whole framebuffer, kept in RAM or
+ * FLASH, that's never drawn on.  The drawing buffer holds
+ * only the overlay.  When draw() copies a changed row out
+ * to the panel, each half of each byte comes from the
+ * overlay, unless it's the key color, in which case it
+ * comes from the background.  So a sketch only redraws the
+ * parts that change, and clear() (with the default black
+ * key) shows the background again.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+
+#if HUB75_LAYERS
+
+#include "Arduino.h"
+
+/********************************************************
+* setBackground()
+*********************************************************
+* Set the background shown where the overlay is the key
+* color.  It's a copy of a whole framebuffer, laid out the
+* same way: saveBackground() makes one in RAM, and
+* img2anim.py --background one in FLASH.  Every row is
+* merged again at the next draw()
+*
+* Parameters:
+*   const uint8_t* bg - PLANES * SCANROWS * BUFFCOLS bytes,
+*     or NULL to turn the background off
+*   bool inFlash - true if 'bg' is in PROGMEM
+*   Uno_HUB75_Driver::Colors key - overlay color that shows
+*     the background
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::setBackground(const uint8_t* bg, bool inFlash, Uno_HUB75_Driver::Colors key)
+{
+  background = bg;
+  bgInFlash = inFlash;
+  bgKey = (uint8_t)key;
+
+  dirtyRows = ALLROWS;
+}
+
+/********************************************************
+* saveBackground()
+*********************************************************
+* Copy the drawing buffer, with everything drawn so far,
+* to use as a background.  Draw the static parts, save
+* them, set them as the background and clear()
+*
+* Parameters:
+*   uint8_t* bg - PLANES * SCANROWS * BUFFCOLS bytes
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::saveBackground(uint8_t* bg)
+{
+  memcpy(bg, pixBuff[0], PLANES * SCANROWS * BUFFCOLS);
+}
+
+/********************************************************
+* mergeRows()
+*********************************************************
+* Like copyRows() from the drawing buffer to the output
+* buffer, but with the background showing through the key
+* color.  A pixel is the key color when it is in every
+* bit-plane, so BCM levels close to it still cover the
+* background
+*
+* Parameters:
+*   Uno_HUB75_Driver::RowMask rows - bit 'n' set to merge
+*     buffer row 'n'
+*   bool blockISR - true to turn off the HUB75 timer ISR while
+*     merging each row
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::mergeRows(Uno_HUB75_Driver::RowMask rows, bool blockISR)
+{
+  uint8_t keyTop = bgKey << 2;
+  uint8_t keyBottom = bgKey << 5;
+
+  for (uint8_t row = 0; rows; ++row, rows >>= 1)
+  {
+    if (!(rows & 0x01))
+    {
+      continue;
+    }
+
+    // only held off for one row at a time
+    if (blockISR)
+    {
+      HUB75_TIMSK &= ~bit(HUB75_OCIEA);
+    }
+
+    uint8_t* over = pixBuff[row];
+    uint8_t* out = updBuff[row];
+    const uint8_t* bg = background + row * BUFFCOLS;
+
+    for (uint8_t* end = over + BUFFCOLS; over < end; ++over, ++out, ++bg)
+    {
+      // bits taken from the background: both halves, until a
+      // bit-plane shows that half isn't the key
+      uint8_t fromBg = 0xfc;
+
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        uint8_t b = over[plane * SCANROWS * BUFFCOLS];
+
+        if ((b & 0x1c) != keyTop)
+        {
+          fromBg &= ~0x1c;
+        }
+
+        if ((b & 0xe0) != keyBottom)
+        {
+          fromBg &= ~0xe0;
+        }
+      }
+
+      for (uint8_t plane = 0; plane < PLANES; ++plane)
+      {
+        uint16_t offset = plane * SCANROWS * BUFFCOLS;
+        uint8_t b = bgInFlash ? pgm_read_byte(bg + offset) : bg[offset];
+
+        out[offset] = (over[offset] & ~fromBg) | (b & fromBg);
+      }
+    }
+
+    if (blockISR)
+    {
+      HUB75_TIMSK |= bit(HUB75_OCIEA);
+    }
+  }
+}
+
+#endif // HUB75_LAYERS
@@ -0,0 +1,186 @@
+/**********************************************************
+ * @file    Uno_HUB75_Ports.h
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Which AVR ports, pins and timer the panel is driven
+ * with, picked at compile time by the board.
+ *
+ * Every board keeps the 6 color lines on bits 2 to 7 of
+ * one port, in the order of the framebuffer bits, so each
+ * column is still a single 'out' of a buffer byte.  Row
+ * A, B and C, CLK, LAT and OE share another port, so
+ * clocking is an 'out' to its PINx register (which toggles
+ * the pins written as 1) and the rest are sbi/cbi.  Row D
+ * can be any pin.
+ *
+ * update() runs from Timer 2, or Timer 3 on the 32U4,
+ * which doesn't have a Timer 2.  The rest of the library
+ * calls it the HUB75 timer.  Both count 4 us ticks with
+ * the same prescalers, so times in ticks are the same on
+ * every board.
+ *
+ * To add a board, copy the block closest to it.  The
+ * ports have to be in the low I/O space (PORTA to PORTG),
+ * where sbi, cbi and out reach them, and A, B, C and CLK
+ * have to be bits 0 to 3 of the control port, which
+ * latchRow() and the naked ISR count on.
+**********************************************************/
+#ifndef UNO_HUB75_PORTS_H_
+#define UNO_HUB75_PORTS_H_
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__)
+/**********************************************************
+* Uno, Nano, Pro Mini (ATmega328P, 2K of RAM)
+*
+*   colors  PORTD 2-7   pins 2 to 7 (0 and 1 stay the UART)
+*   A B C   PORTB 0-2   pins 8, 9, 10
+*   CLK     PORTB 3     pin 11
+*   LAT     PORTB 4     pin 12
+*   OE      PORTB 5     pin 13
+*   D       PORTC 0     pin A0
+**********************************************************/
+#define HUB75_COLOR_PORT  PORTD
+#define HUB75_COLOR_DDR   DDRD
+#define HUB75_CTL_PORT    PORTB
+#define HUB75_CTL_PINS    PINB
+#define HUB75_CTL_DDR     DDRB
+#define PIN_CLK           3
+#define PIN_LAT           4
+#define PIN_OE            5
+
+#define PORT_RD           PORTC
+#define DDR_RD            DDRC
+#define PIN_RD            0
+
+// framebuffer bytes that leave enough for the stack and sketch
+#define HUB75_BUFF_RAM    1536
+
+#define HUB75_TIMER2      1
+
+#elif defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+/**********************************************************
+* Mega 2560 and 1280 (8K of RAM)
+*
+*   colors  PORTA 2-7   pins 24 to 29 (22 and 23 unused)
+*   A B C   PORTC 0-2   pins 37, 36, 35
+*   CLK     PORTC 3     pin 34
+*   LAT     PORTC 4     pin 33
+*   OE      PORTC 5     pin 32
+*   D       PORTC 6     pin 31
+**********************************************************/
+#define HUB75_COLOR_PORT  PORTA
+#define HUB75_COLOR_DDR   DDRA
+#define HUB75_CTL_PORT    PORTC
+#define HUB75_CTL_PINS    PINC
+#define HUB75_CTL_DDR     DDRC
+#define PIN_CLK           3
+#define PIN_LAT           4
+#define PIN_OE            5
+
+#define PORT_RD           PORTC
+#define DDR_RD            DDRC
+#define PIN_RD            6
+
+#define HUB75_BUFF_RAM    7168
+
+#define HUB75_TIMER2      1
+
+#elif defined(__AVR_ATmega32U4__)
+/**********************************************************
+* Leonardo, Micro, Pro Micro (ATmega32U4, 2.5K of RAM)
+*
+*   colors  PORTB 2-7   MOSI (16), MISO (14), pins 8 to 11
+*   A B C   PORTD 0-2   pins 3, 2, 0
+*   CLK     PORTD 3     pin 1
+*   LAT     PORTD 4     pin 4
+*   OE      PORTD 7     pin 6
+*   D       PORTD 6     pin 12
+*
+* Two traps when wiring it:
+*   - R1 and G1 are MOSI and MISO.  On a Leonardo those
+*     are only on the 6 pin ICSP header, not the pin
+*     headers; SCK (PB1) is next to them there and isn't
+*     used.  A Micro or Pro Micro has them as pins 16 and
+*     14.
+*   - CLK is pin 1, TX of Serial1, and row C is pin 0, its
+*     RX.  Don't call Serial1.begin(), which would take
+*     both over.  Serial is the USB port, and still works.
+* None of it is where it is on an Uno, so don't wire a
+* Leonardo from the Uno table.
+**********************************************************/
+#define HUB75_COLOR_PORT  PORTB
+#define HUB75_COLOR_DDR   DDRB
+#define HUB75_CTL_PORT    PORTD
+#define HUB75_CTL_PINS    PIND
+#define HUB75_CTL_DDR     DDRD
+#define PIN_CLK           3
+#define PIN_LAT           4
+#define PIN_OE            7
+
+#define PORT_RD           PORTD
+#define DDR_RD            DDRD
+#define PIN_RD            6
+
+// the USB stack needs some of the 2.5K
+#define HUB75_BUFF_RAM    1792
+
+#define HUB75_TIMER2      0
+
+#else
+#error There are no HUB75 port assignments for this board; add them to Uno_HUB75_Ports.h
+#endif
+
+// row address lines, the same on every board
+#define PIN_RA            0
+#define PIN_RB            1
+#define PIN_RC            2
+
+#if HUB75_TIMER2
+// Timer 2: 8 bits, CTC is WGM21 in TCCR2A
+#define HUB75_TIMER_VECT    TIMER2_COMPA_vect
+#define HUB75_TIMER_B_VECT  TIMER2_COMPB_vect
+#define HUB75_TCCRA         TCCR2A
+#define HUB75_TCCRB         TCCR2B
+#define HUB75_OCRA          OCR2A
+#define HUB75_OCRB          OCR2B
+#define HUB75_TCNT          TCNT2
+#define HUB75_TIMSK         TIMSK2
+#define HUB75_TIFR          TIFR2
+#define HUB75_OCIEA         OCIE2A
+#define HUB75_OCIEB         OCIE2B
+#define HUB75_OCFA          OCF2A
+#define HUB75_OCFB          OCF2B
+#define HUB75_CTC_A         bit(WGM21)
+#define HUB75_CTC_B         0
+#define HUB75_DIV64         bit(CS22)
+#define HUB75_DIV256        (bit(CS22) | bit(CS21))
+#else
+// Timer 3: 16 bits, but only ever counts to less than 256.
+// CTC is WGM32 in TCCR3B, and the prescaler bits differ
+#define HUB75_TIMER_VECT    TIMER3_COMPA_vect
+#define HUB75_TIMER_B_VECT  TIMER3_COMPB_vect
+#define HUB75_TCCRA         TCCR3A
+#define HUB75_TCCRB         TCCR3B
+#define HUB75_OCRA          OCR3A
+#define HUB75_OCRB          OCR3B
+#define HUB75_TCNT          TCNT3
+#define HUB75_TIMSK         TIMSK3
+#define HUB75_TIFR          TIFR3
+#define HUB75_OCIEA         OCIE3A
+#define HUB75_OCIEB         OCIE3B
+#define HUB75_OCFA          OCF3A
+#define HUB75_OCFB          OCF3B
+#define HUB75_CTC_A         0
+#define HUB75_CTC_B         bit(WGM32)
+#define HUB75_DIV64         (bit(CS31) | bit(CS30))
+#define HUB75_DIV256        bit(CS32)
+#endif
+
+// the 32U4 has USART 1 instead, on pins 0 and 1, which are row C
+// and CLK here
+#if defined(__AVR_ATmega32U4__) && HUB75_STREAM
+#error HUB75_STREAM needs USART 0, which the 32U4 does not have
+#endif
+
+#endif // UNO_HUB75_PORTS_H_
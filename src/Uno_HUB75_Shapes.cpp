@@ -0,0 +1,443 @@
+/**********************************************************
+ * @file    Uno_HUB75_Shapes.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Circle, ellipse, triangle and polygon methods for the
+ * Uno_HUB75_Driver class.
+ *
+ * The outlines are worked out with integer midpoint and
+ * Bresenham steps, no floating point or division.  Filled
+ * shapes are drawn as one horizontal span per panel row,
+ * each going through spanFill(), so a span is a masked
+ * store per buffer byte (or a memset()) instead of a
+ * setBuff() per pixel.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+#include "Uno_HUB75_Driver_impl.h"
+
+#include "Arduino.h"
+
+/********************************************************
+* plot()
+*********************************************************
+* setBuff() for a pixel that may be off the panel
+*
+* Parameters:
+*   int16_t x - the X coordinate
+*   int16_t y - the Y coordinate
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
+* Returns
+*   void
+********************************************************/
+inline void Uno_HUB75_Driver::plot(int16_t x, int16_t y, Uno_HUB75_Driver::Pixel c)
+{
+  if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT)
+  {
+    this->setBuff(x, y, c);
+  }
+}
+
+/********************************************************
+* circle()
+*********************************************************
+* Draw a circle, and optionally fill it.  Midpoint circle
+* algorithm: one octant is stepped out a row at a time
+* with an integer error term, and mirrored into the
+* other 7.
+*
+* Filled, each row of the circle is one span from its
+* left edge to its right, so a circle of radius 'r' is
+* 2 * r + 1 spanFill()s
+*
+* Parameters:
+*   int16_t x - X coordinate of the center
+*   int16_t y - Y coordinate of the center
+*   int16_t r - radius; 0 is a single pixel
+*   Uno_HUB75_Driver::Colors color - line and fill color
+*   bool fill - true to fill with color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::circle(int16_t x, int16_t y, int16_t r, Uno_HUB75_Driver::Colors color, bool fill)
+{
+  if (r < 0)
+  {
+    return;
+  }
+
+  Uno_HUB75_Driver::Pixel c = toPixel(color);
+
+  // the octant from straight right to 45 degrees down
+  int16_t dx = r;
+  int16_t dy = 0;
+  int16_t err = 1 - r;
+
+  while (dx >= dy)
+  {
+    if (fill)
+    {
+      // the rows dy from the center are dx either side...
+      this->spanFill(x - dx, y + dy, x + dx, y + dy, c);
+      if (dy)
+      {
+        this->spanFill(x - dx, y - dy, x + dx, y - dy, c);
+      }
+
+      // ...and the rows dx from the center dy either side, the
+      // last time through for each dx
+      if (err >= 0 && dx != dy)
+      {
+        this->spanFill(x - dy, y + dx, x + dy, y + dx, c);
+        this->spanFill(x - dy, y - dx, x + dy, y - dx, c);
+      }
+    }
+    else
+    {
+      this->plot(x + dx, y + dy, c);
+      this->plot(x - dx, y + dy, c);
+      this->plot(x + dx, y - dy, c);
+      this->plot(x - dx, y - dy, c);
+      this->plot(x + dy, y + dx, c);
+      this->plot(x - dy, y + dx, c);
+      this->plot(x + dy, y - dx, c);
+      this->plot(x - dy, y - dx, c);
+    }
+
+    ++dy;
+
+    if (err < 0)
+    {
+      err += 2 * dy + 1;
+    }
+    else
+    {
+      --dx;
+      err += 2 * (dy - dx) + 1;
+    }
+  }
+}
+
+/********************************************************
+* ellipse()
+*********************************************************
+* Draw an ellipse with its axes along X and Y, and
+* optionally fill it.  Midpoint ellipse algorithm: the
+* top right quarter is stepped out from the top, a column
+* at a time while the edge is flatter than 45 degrees and
+* a row at a time after that, with 32 bit integer error
+* terms, and mirrored into the other 3.
+*
+* Filled, each row is one span, drawn when the stepping
+* leaves it.  The terms get as big as 2 * rx * rx * ry,
+* so radii over 1000 would overflow them, and aren't
+* drawn
+*
+* Parameters:
+*   int16_t x - X coordinate of the center
+*   int16_t y - Y coordinate of the center
+*   int16_t rx - radius along X
+*   int16_t ry - radius along Y
+*   Uno_HUB75_Driver::Colors color - line and fill color
+*   bool fill - true to fill with color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::ellipse(int16_t x, int16_t y, int16_t rx, int16_t ry, Uno_HUB75_Driver::Colors color, bool fill)
+{
+  if (rx < 0 || ry < 0 || rx > 1000 || ry > 1000)
+  {
+    return;
+  }
+
+  Uno_HUB75_Driver::Pixel c = toPixel(color);
+
+  // flat; the stepping below needs both radii
+  if (!rx || !ry)
+  {
+    this->spanFill(x - rx, y - ry, x + rx, y + ry, c);
+    return;
+  }
+
+  int32_t rx2 = (int32_t)rx * rx;
+  int32_t ry2 = (int32_t)ry * ry;
+
+  // the point, and twice the slope's terms at it
+  int16_t dx = 0;
+  int16_t dy = ry;
+  int32_t px = 0;
+  int32_t py = 2 * rx2 * dy;
+
+  // 1: a column at a time, the row moving up now and then
+  int32_t p = ry2 - rx2 * ry + rx2 / 4;
+
+  while (px < py)
+  {
+    if (!fill)
+    {
+      this->plot(x + dx, y + dy, c);
+      this->plot(x - dx, y + dy, c);
+      this->plot(x + dx, y - dy, c);
+      this->plot(x - dx, y - dy, c);
+    }
+
+    ++dx;
+    px += 2 * ry2;
+
+    if (p < 0)
+    {
+      p += ry2 + px;
+    }
+    else
+    {
+      // leaving this row; its span is as wide as it got
+      if (fill)
+      {
+        this->spanFill(x - dx + 1, y + dy, x + dx - 1, y + dy, c);
+        this->spanFill(x - dx + 1, y - dy, x + dx - 1, y - dy, c);
+      }
+
+      --dy;
+      py -= 2 * rx2;
+      p += ry2 + px - py;
+    }
+  }
+
+  // 2: a row at a time, the column moving out now and then.
+  // Moving the midpoint tested from (dx + 1, dy - 1/2) to
+  // (dx + 1/2, dy - 1) changes the error by 3/4 (rx2 - ry2)
+  // - (px + py) / 2, rounded the way the two starting values are.
+  // Worked out from scratch it would need rx2 * ry2
+  p += (rx2 - rx2 / 4) - (ry2 - ry2 / 4) - px / 2 - py / 2;
+
+  while (dy >= 0)
+  {
+    if (fill)
+    {
+      this->spanFill(x - dx, y + dy, x + dx, y + dy, c);
+      if (dy)
+      {
+        this->spanFill(x - dx, y - dy, x + dx, y - dy, c);
+      }
+    }
+    else
+    {
+      this->plot(x + dx, y + dy, c);
+      this->plot(x - dx, y + dy, c);
+      this->plot(x + dx, y - dy, c);
+      this->plot(x - dx, y - dy, c);
+    }
+
+    --dy;
+    py -= 2 * rx2;
+
+    if (p > 0)
+    {
+      p += rx2 - py;
+    }
+    else
+    {
+      ++dx;
+      px += 2 * ry2;
+      p += rx2 - py + px;
+    }
+  }
+}
+
+/********************************************************
+* triangle()
+*********************************************************
+* Draw a triangle, and optionally fill it; a polygon()
+* with 3 corners
+*
+* Parameters:
+*   int16_t x1, y1 - first corner
+*   int16_t x2, y2 - second corner
+*   int16_t x3, y3 - third corner
+*   Uno_HUB75_Driver::Colors color - line and fill color
+*   bool fill - true to fill with color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::triangle(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, Uno_HUB75_Driver::Colors color, bool fill)
+{
+  Uno_HUB75_Driver::Point pts[3] = {{x1, y1}, {x2, y2}, {x3, y3}};
+
+  this->polygon(pts, 3, color, fill);
+}
+
+/********************************************************
+* Walks one side of a convex polygon from its top corner
+* to its bottom one, edge by edge, and gives the columns
+* it covers in each row.  Each edge is stepped the way
+* line() would draw it, so the fill covers exactly the
+* outline's pixels
+********************************************************/
+class PolygonSide
+{
+public:
+  // start at corner 'top', going 'step' (1 or -1) around the
+  // 'count' corners at 'p', and stop at corner 'last'
+  PolygonSide(const Uno_HUB75_Driver::Point* p, uint8_t count, uint8_t top, uint8_t last, int8_t step) :
+        pts(p), n(count), corner(top), bottom(last), dir(step)
+  {
+    x = pts[top].x;
+    y = pts[top].y;
+    this->nextEdge();
+  }
+
+  // widen 'lo'/'hi' to the side's pixels in row 'row', if any.
+  // Rows have to be asked for top to bottom
+  void span(int16_t row, int16_t& lo, int16_t& hi)
+  {
+    while (y == row)
+    {
+      if (x < lo)   lo = x;
+      if (x > hi)   hi = x;
+
+      if (x == endX && y == endY)
+      {
+        // a corner; go on along the next edge, if there is one
+        if (corner == bottom)
+        {
+          return;
+        }
+
+        this->nextEdge();
+        continue;
+      }
+
+      // a step along the major axis, and now and then the minor
+      bool minor = false;
+
+      err += errMinor;
+      if (err >= errMajor)
+      {
+        err -= errMajor;
+        minor = true;
+      }
+
+      if (flat || minor)    x += sx;
+      if (!flat || minor)   ++y;
+    }
+  }
+
+private:
+  // set up the edge from the current corner to the next
+  void nextEdge()
+  {
+    corner = (corner + dir + n) % n;
+    endX = pts[corner].x;
+    endY = pts[corner].y;
+
+    // an edge can be up to 65535 long
+    int32_t dx = abs((int32_t)endX - x);
+    int32_t dy = abs((int32_t)endY - y);
+
+    sx = (endX < x) ? -1 : 1;
+    flat = (dx >= dy);
+    errMajor = 2 * (flat ? dx : dy);
+    errMinor = 2 * (flat ? dy : dx);
+
+    // line() steps from the end that's lower along the major
+    // axis.  Going from the other end, an error term one less
+    // than line()'s moves along the minor axis at the same
+    // pixels line() does
+    err = errMajor / 2;
+    if (flat && sx < 0)
+    {
+      --err;
+    }
+  }
+
+  const Uno_HUB75_Driver::Point* pts;
+  uint8_t n;
+  uint8_t corner;             // end of the edge being walked
+  uint8_t bottom;
+  int8_t dir;
+
+  int16_t x;                  // pixel the walk is on
+  int16_t y;
+  int16_t endX;               // end of the edge
+  int16_t endY;
+  int8_t sx;                  // X step, 1 or -1
+  bool flat;                  // X is the major axis
+  int32_t err;
+  int32_t errMajor;
+  int32_t errMinor;
+};
+
+/********************************************************
+* polygon()
+*********************************************************
+* Draw a polygon by its corners, in order either way
+* around, and optionally fill it.  The outline is a line()
+* from each corner to the next, and back to the first.
+*
+* Filling only works for a convex polygon (no corner
+* pointing in).  Both sides are walked from the top
+* corner to the bottom one, and each row is one span
+* between them, covering the pixels the outline would.
+* Every step is integer adds and compares, and rows below
+* the panel aren't walked
+*
+* Parameters:
+*   const Uno_HUB75_Driver::Point* pts - the corners
+*   uint8_t n - number of corners
+*   Uno_HUB75_Driver::Colors color - line and fill color
+*   bool fill - true to fill with color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::polygon(const Uno_HUB75_Driver::Point* pts, uint8_t n, Uno_HUB75_Driver::Colors color, bool fill)
+{
+  if (!n)
+  {
+    return;
+  }
+
+  if (!fill)
+  {
+    for (uint8_t ii = 0; ii < n; ++ii)
+    {
+      const Uno_HUB75_Driver::Point& next = pts[(ii + 1) % n];
+
+      this->line(pts[ii].x, pts[ii].y, next.x, next.y, color);
+    }
+
+    return;
+  }
+
+  // the top and bottom corners
+  uint8_t top = 0;
+  uint8_t bottom = 0;
+
+  for (uint8_t ii = 1; ii < n; ++ii)
+  {
+    if (pts[ii].y < pts[top].y)       top = ii;
+    if (pts[ii].y > pts[bottom].y)    bottom = ii;
+  }
+
+  Uno_HUB75_Driver::Pixel c = toPixel(color);
+  PolygonSide fwd(pts, n, top, bottom, 1);
+  PolygonSide back(pts, n, top, bottom, -1);
+
+  // the sides have to be walked through the rows above the
+  // panel to get to it, but can stop at the bottom of it
+  int16_t last = min(pts[bottom].y, (int16_t)MAXY);
+
+  for (int16_t row = pts[top].y; row <= last; ++row)
+  {
+    // nothing yet
+    int16_t lo = 0x7fff;
+    int16_t hi = -0x7fff;
+
+    fwd.span(row, lo, hi);
+    back.span(row, lo, hi);
+
+    if (lo <= hi && row >= 0)
+    {
+      this->spanFill(lo, row, hi, row, c);
+    }
+  }
+}
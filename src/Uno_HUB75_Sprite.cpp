@@ -0,0 +1,324 @@
+/**********************************************************
+ * @file    Uno_HUB75_Sprite.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Sprite method for the Uno_HUB75_Driver class.
+ *
+ * Sprites are read a row at a time straight from FLASH.
+ * Each sprite is clipped to the panel once.  Then, when
+ * the panel's columns are in order in the buffer, each row
+ * of the sprite is written into the buffer bytes it lands
+ * on, one after another, without mapping every pixel.
+ * With HUB75_BITPLANE, rows of 1bpp sprites are written 8
+ * pixels at a time instead.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+#include "Uno_HUB75_Driver_impl.h"
+
+#include "Arduino.h"
+
+// a pixel that isn't drawn
+#define SPRITE_CLEAR  0xff
+
+/********************************************************
+* drawSprite()
+*********************************************************
+* Draw one frame of a sprite.  Like text, the top row of
+* the sprite goes at Y, and each row after that one pixel
+* lower in Y (see drawGlyph()).
+*
+* The sprite is clipped to the panel first.  Then for each
+* row, the first pixel is mapped to the framebuffer, and
+* the rest follow it byte by byte; each one only has the
+* 3 bits of its half of the panel replaced, in every
+* bit-plane.  With a translation method, or a framebuffer
+* that isn't laid out like the panel, pixels are stored one
+* at a time instead.
+*
+* Parameters:
+*   int16_t x - X coordinate of the left column
+*   int16_t y - Y coordinate of the top row
+*   const Uno_HUB75_Driver::Sprite* sprite - the sprite, in
+*     PROGMEM
+*   uint8_t frame - which frame; wraps around
+*   Uno_HUB75_Driver::Colors c - color of a 1bpp sprite
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::drawSprite(int16_t x, int16_t y, const Uno_HUB75_Driver::Sprite* sprite, uint8_t frame, Uno_HUB75_Driver::Colors c)
+{
+  // the header is only a few bytes; get it out of FLASH once
+  Uno_HUB75_Driver::Sprite s;
+  memcpy_P(&s, sprite, sizeof(s));
+
+  // all of it off the left edge.  Checked first, since -x and
+  // MAXX - x below don't fit in 16 bits for an X near -32768
+  if ((int32_t)x + s.width <= 0)
+  {
+    return;
+  }
+
+  // columns on the panel
+  int16_t col1 = (x < 0) ? -x : 0;
+  int16_t col2 = min((int16_t)(s.width - 1), (int16_t)(MAXX - x));
+
+  // sprite row 'r' is at y - r, so these are the rows on the panel
+  int16_t row1 = max((int16_t)0, (int16_t)(y - MAXY));
+  int16_t row2 = min((int16_t)(s.height - 1), y);
+
+  if (col1 > col2 || row1 > row2)
+  {
+    return;
+  }
+
+  // pixels per byte, less one, and bytes per row
+  bool oneBit = (s.format == Uno_HUB75_Driver::SPRITE_1BPP);
+  uint8_t posMask = oneBit ? 0x07 : 0x01;
+  uint8_t rowBytes = oneBit ? (s.width + 7) / 8 : (s.width + 1) / 2;
+
+  if (s.frames)
+  {
+    frame %= s.frames;
+  }
+
+  const uint8_t* bits = s.bitmap + ((uint16_t)frame * s.height + row1) * rowBytes;
+  bits += oneBit ? (col1 >> 3) : (col1 >> 1);
+
+#if PIXEL_RUNS
+  bool direct = !xlatFunc;
+#endif
+
+  for (int16_t row = row1; row <= row2; ++row, bits += rowBytes)
+  {
+    int16_t py = y - row;
+
+#if BIT_RUNS
+    if (oneBit && !xlatFunc && this->blitBits(x + col1, py, bits, col1 & 0x07, col2 - col1 + 1, c))
+    {
+      continue;
+    }
+#endif
+
+#if PIXEL_RUNS
+    uint8_t* dst = NULL;
+    int8_t step = 0;
+    uint8_t shift = 2;
+    uint8_t keep = 0xe3;
+
+    if (direct)
+    {
+      // where the first pixel is, and which way the next one is
+      int16_t bx = x + col1;
+      int16_t by = py;
+      int16_t nx = bx + 1;
+      int16_t ny = py;
+
+      xform(bx, by);
+      chainMap(bx, by);
+      xform(nx, ny);
+      chainMap(nx, ny);
+
+      step = (nx < bx) ? -1 : 1;
+
+      // same as putBuff(); the bottom half is in the high bits
+      if (by >= SCANROWS)
+      {
+        by -= SCANROWS;
+        shift = 5;
+        keep = 0x1f;
+      }
+
+#if HUB75_DISPLAY_LIST
+      if (!(clipRows & bit(by)))
+      {
+        continue;
+      }
+#endif
+
+      dirtyRows |= bit(by);
+      dst = &pixBuff[by][bx];
+    }
+#endif
+
+    const uint8_t* src = bits;
+    uint8_t pos = col1 & posMask;
+    uint8_t data = pos ? pgm_read_byte(src++) : 0;
+
+    for (int16_t col = col1; col <= col2; ++col)
+    {
+      if (!pos)
+      {
+        data = pgm_read_byte(src++);
+      }
+
+      uint8_t code;
+
+      if (oneBit)
+      {
+        code = (data & (0x80 >> pos)) ? (uint8_t)c : SPRITE_CLEAR;
+      }
+      else
+      {
+        code = pos ? (data & 0x0f) : (data >> 4);
+        if (code == s.key || code > Uno_HUB75_Driver::WHITE)
+        {
+          code = SPRITE_CLEAR;
+        }
+      }
+
+      pos = (pos + 1) & posMask;
+
+      if (code != SPRITE_CLEAR)
+      {
+#if PIXEL_RUNS
+        if (direct)
+        {
+          // a Colors value is the same code in every bit-plane
+          uint8_t val = code << shift;
+
+          for (uint8_t plane = 0; plane < PLANES; ++plane)
+          {
+            uint8_t& buf = dst[plane * SCANROWS * BUFFCOLS];
+            buf = (buf & keep) | val;
+          }
+        }
+        else
+#endif
+        if (xlatFunc)
+        {
+          this->setBuff(x + col, py, toPixel((Uno_HUB75_Driver::Colors)code));
+        }
+        else
+        {
+          this->putBuff(x + col, py, toPixel((Uno_HUB75_Driver::Colors)code));
+        }
+      }
+
+#if PIXEL_RUNS
+      // doesn't move without 'direct'
+      dst += step;
+#endif
+    }
+  }
+}
+
+#if BIT_RUNS
+/********************************************************
+* blitBits()
+*********************************************************
+* HUB75_BITPLANE only.  Draw one row of a 1bpp sprite,
+* which is already laid out like a color line: 8 pixels a
+* byte, leftmost in the top bit.  Each byte of the line it
+* lands on gets the 8 sprite bits that go there, shifted
+* into place, set or cleared in each of the 3 color lines
+* of its half of the panel at once.
+*
+* Only when the row runs left to right in the buffer; not
+* with a mirrored or rotated 180 panel
+*
+* Parameters:
+*   int16_t x - X coordinate of the first pixel
+*   int16_t y - Y coordinate of the row
+*   const uint8_t* src - sprite byte holding the first
+*     pixel, in PROGMEM
+*   uint8_t pos - bit of it (from the top, 0 to 7)
+*   uint8_t n - pixels in the row, all on the panel
+*   Uno_HUB75_Driver::Colors c - color of the set bits
+* Returns
+*   bool - false if the row runs the other way and wasn't
+*     drawn
+********************************************************/
+bool Uno_HUB75_Driver::blitBits(int16_t x, int16_t y, const uint8_t* src, uint8_t pos, uint8_t n, Uno_HUB75_Driver::Colors c)
+{
+  // where the first pixel is, and which way the next one is
+  int16_t bx = x;
+  int16_t by = y;
+  int16_t nx = x + 1;
+  int16_t ny = y;
+
+  xform(bx, by);
+  chainMap(bx, by);
+  xform(nx, ny);
+  chainMap(nx, ny);
+
+  if (nx < bx)
+  {
+    return (false);
+  }
+
+  // the bottom half is in the last 3 color lines
+  uint8_t half = 0;
+
+  if (by >= SCANROWS)
+  {
+    by -= SCANROWS;
+    half = 3 * LINEBYTES;
+  }
+
+#if HUB75_DISPLAY_LIST
+  if (!(clipRows & bit(by)))
+  {
+    return (true);
+  }
+#endif
+
+  dirtyRows |= bit(by);
+
+  // how far right the sprite's bits move to land in place; when
+  // it's left, start a byte later, with the first byte's bits
+  // coming in from the left
+  uint8_t first = bx & 0x07;
+  int8_t shift = first - pos;
+  uint8_t left = (pos + n + 7) >> 3;
+  uint8_t prev = 0;
+
+  if (shift < 0)
+  {
+    prev = pgm_read_byte(src++);
+    --left;
+    shift += 8;
+  }
+
+  uint8_t count = (first + n + 7) >> 3;
+  uint8_t lastMask = 0xff << (7 - ((first + n - 1) & 0x07));
+  uint8_t* dst = &pixBuff[by][half + (bx >> 3)];
+
+  for (uint8_t ii = 0; ii < count; ++ii, ++dst)
+  {
+    uint8_t cur = 0;
+
+    if (left)
+    {
+      cur = pgm_read_byte(src++);
+      --left;
+    }
+
+    uint8_t mask = (uint8_t)((((uint16_t)prev << 8) | cur) >> shift);
+    prev = cur;
+
+    if (!ii)
+    {
+      mask &= 0xff >> first;
+    }
+
+    if (ii == count - 1)
+    {
+      mask &= lastMask;
+    }
+
+    // a Colors value is the same code in every bit-plane
+    for (uint8_t plane = 0; plane < PLANES; ++plane)
+    {
+      uint8_t* line = dst + plane * SCANROWS * ROWBYTES;
+
+      for (uint8_t code = c, jj = 0; jj < 3; ++jj, code >>= 1, line += LINEBYTES)
+      {
+        *line = (code & 0x01) ? (*line | mask) : (*line & ~mask);
+      }
+    }
+  }
+
+  return (true);
+}
+#endif
@@ -0,0 +1,285 @@
+/**********************************************************
+ * @file    Uno_HUB75_Stream.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Streaming methods for the Uno_HUB75_Driver class
+ * (HUB75_STREAM).
+ *
+ * A host sends frames over the serial port already packed
+ * the way the framebuffer is, so each byte received goes
+ * straight from UDR0 into the drawing buffer.  When a
+ * frame is committed, draw() asks update() to flip.  Until
+ * it has, the drawing buffer is still on the panel, so
+ * bytes received meanwhile wait in a small ring; once the
+ * flip is done (the ACK byte going out sets off the
+ * transmit ISR) they're put in the new drawing buffer with
+ * interrupts back on.
+ *
+ * At 500 kbaud a byte comes every 20 us.  The receive ISR
+ * only stores the byte, and the UART holds 2 more, so it
+ * keeps up with the one-row-per-interrupt and BCM
+ * update()s (about 22 us); the full frame update() blocks
+ * for too long and drops bytes at that speed.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+
+#if HUB75_STREAM
+
+#include "Arduino.h"
+
+// the Mega's first USART has a number
+#if defined(USART0_RX_vect)
+#define STREAM_RX_vect  USART0_RX_vect
+#define STREAM_TX_vect  USART0_TX_vect
+#else
+#define STREAM_RX_vect  USART_RX_vect
+#define STREAM_TX_vect  USART_TX_vect
+#endif
+
+#define RINGMASK    (HUB75_STREAM_RING - 1)
+
+// the panel the ISRs feed; set by beginStream()
+static Uno_HUB75_Driver* streamPanel = NULL;
+
+/********************************************************
+* beginStream()
+*********************************************************
+* Start taking frames from the serial port.  Call it after
+* begin(true).  The USART is set to 8N1 at double speed,
+* so 500000 and 1000000 baud are exact at 16 MHz
+*
+* Parameters:
+*   uint32_t baud - bits per second
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::beginStream(uint32_t baud)
+{
+  UCSR0B = 0;
+
+  streamHead = 0;
+  streamTail = 0;
+  streamBusy = false;
+  streamPos = 0;
+  streamEnd = 0;
+  streamErrs = 0;
+  streamPanel = this;
+
+  UCSR0A = bit(U2X0);
+  UBRR0 = (F_CPU / 8 + baud / 2) / baud - 1;
+  UCSR0C = bit(UCSZ01) | bit(UCSZ00);
+  UCSR0B = bit(RXEN0) | bit(TXEN0) | bit(RXCIE0) | bit(TXCIE0);
+
+  streaming = true;
+}
+
+/********************************************************
+* endStream()
+*********************************************************
+* Stop taking frames, and let go of the USART
+********************************************************/
+void Uno_HUB75_Driver::endStream()
+{
+  UCSR0B = 0;
+  streaming = false;
+}
+
+/********************************************************
+* streamRx()
+*********************************************************
+* Receive ISR.  Normally the byte goes straight into the
+* drawing buffer.  If a frame is waiting to be shown (or
+* the ring is being emptied, or has bytes that came
+* first), it goes in the ring instead
+********************************************************/
+void Uno_HUB75_Driver::streamRx()
+{
+  uint8_t status = UCSR0A;
+  uint8_t b = UDR0;
+
+  // a bad byte, or ones lost before it
+  if (status & (bit(FE0) | bit(DOR0)))
+  {
+    ++streamErrs;
+  }
+
+  if (!streamBusy && !pendingFlip && !syncRows && streamHead == streamTail)
+  {
+    this->streamByte(b);
+    return;
+  }
+
+  uint8_t next = (streamHead + 1) & RINGMASK;
+
+  if (next == streamTail)
+  {
+    ++streamErrs;
+  }
+  else
+  {
+    streamRing[streamHead] = b;
+    streamHead = next;
+  }
+
+  this->streamDrain();
+}
+
+/********************************************************
+* streamTx()
+*********************************************************
+* Transmit complete ISR; the ACK for a flip has gone out,
+* so the new drawing buffer is free
+********************************************************/
+void Uno_HUB75_Driver::streamTx()
+{
+  this->streamDrain();
+}
+
+/********************************************************
+* streamDrain()
+*********************************************************
+* Bring the drawing buffer up to date after a flip, and
+* put the bytes from the ring in it.  That can take a
+* while, so it's done with interrupts on; bytes that come
+* meanwhile go in the ring too.  It stops at the next
+* commit, until that frame has been shown
+********************************************************/
+void Uno_HUB75_Driver::streamDrain()
+{
+  // already at it further down the stack, or still flipping
+  if (streamBusy || pendingFlip)
+  {
+    return;
+  }
+
+  streamBusy = true;
+  sei();
+
+  // copy over the rows the last frame changed
+  this->flipPending();
+
+  for (;;)
+  {
+    // checked with interrupts off, so a byte can't be put in the
+    // ring after the last look and before streamBusy is cleared
+    cli();
+
+    if (streamHead == streamTail || pendingFlip)
+    {
+      break;
+    }
+
+    sei();
+
+    uint8_t b = streamRing[streamTail];
+    streamTail = (streamTail + 1) & RINGMASK;
+
+    this->streamByte(b);
+  }
+
+  // the ISR's reti turns interrupts back on
+  streamBusy = false;
+}
+
+/********************************************************
+* streamByte()
+*********************************************************
+* Handle one byte of the stream: a control byte starts a
+* packet or commits the frame, and a data byte is stored
+* at the next place in the packet.  Data that doesn't
+* belong to a packet is ignored
+*
+* Parameters:
+*   uint8_t b - the byte
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::streamByte(uint8_t b)
+{
+  uint8_t cmd = b & 0x03;
+
+  if (!cmd)
+  {
+    if (streamPos < streamEnd)
+    {
+      uint8_t* buff = pixBuff[0];
+      buff[streamPos++] = b;
+    }
+
+    return;
+  }
+
+  // the last packet should be all here by now
+  if (streamPos != streamEnd)
+  {
+    ++streamErrs;
+  }
+
+  streamPos = 0;
+  streamEnd = 0;
+
+  if (cmd == HUB75_STREAM_FRAME)
+  {
+    streamEnd = PLANES * SCANROWS * BUFFCOLS;
+    dirtyRows = ALLROWS;
+  }
+  else if (cmd == HUB75_STREAM_ROW)
+  {
+    // every bit-plane's rows are numbered, one plane after another
+    uint8_t row = b >> 2;
+
+    if (row < PLANES * SCANROWS)
+    {
+      streamPos = row * BUFFCOLS;
+      streamEnd = streamPos + BUFFCOLS;
+      dirtyRows |= bit(row & (SCANROWS - 1));
+    }
+    else
+    {
+      ++streamErrs;
+    }
+  }
+  else
+  {
+    // with nothing new there's nothing to flip, but the host
+    // still waits for the ACK
+    if (!dirtyRows)
+    {
+      UDR0 = HUB75_STREAM_ACK;
+    }
+
+    this->draw();
+  }
+}
+
+#if HUB75_STREAM_ISR
+/********************************************************
+* USART ISRs
+*********************************************************
+* Hand the byte, or the end of a transmission, to the
+* panel that called beginStream().  Serial defines the
+* receive one too, so they can't both be linked in
+********************************************************/
+ISR(STREAM_RX_vect)
+{
+  if (streamPanel)
+  {
+    streamPanel->streamRx();
+  }
+  else
+  {
+    (void)UDR0;
+  }
+}
+
+ISR(STREAM_TX_vect)
+{
+  if (streamPanel)
+  {
+    streamPanel->streamTx();
+  }
+}
+#endif
+
+#endif // HUB75_STREAM
@@ -0,0 +1,342 @@
+/**********************************************************
+ * @file    Uno_HUB75_Text.cpp
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * Text methods for the Uno_HUB75_Driver class.
+ *
+ * Glyphs are read a column at a time straight from FLASH
+ * and written into the drawing framebuffer.  Each glyph is
+ * clipped to the panel once, so pixels are stored without
+ * going through setPixel()'s bounds checking, and without
+ * the translation method test when there isn't one.
+**********************************************************/
+#include "Uno_HUB75_Driver.h"
+#include "Uno_HUB75_Driver_impl.h"
+#include "font.h"
+#include "font3x5.h"
+
+#include "Arduino.h"
+
+// the original font; fixed width, 6 pixels per character
+const Uno_HUB75_Driver::Font hub75Font5x7 PROGMEM =
+{
+  &font5x7[0][0], NULL, 0x00, 0x7f, 5, 7, 1
+};
+
+// the same glyphs, spaced by how wide they are
+const Uno_HUB75_Driver::Font hub75Font5x7Prop PROGMEM =
+{
+  &font5x7[0][0], font5x7Spans, 0x00, 0x7f, 5, 7, 1
+};
+
+// small font, printable characters only
+const Uno_HUB75_Driver::Font hub75Font3x5 PROGMEM =
+{
+  &font3x5[0][0], NULL, 0x20, 0x7e, 3, 5, 1
+};
+
+/********************************************************
+* glyphWidth()
+*********************************************************
+* Find a character's glyph in a font.  Characters the
+* font doesn't have are drawn as the first or last one it
+* does (the DEL block, for characters over 0x7f in the 5x7
+* fonts)
+*
+* Parameters:
+*   const Uno_HUB75_Driver::Font& f - the font, in RAM
+*   uint8_t& chr - the character; changed to the glyph
+*     number in the font
+*   uint8_t& lead - set to the blank columns to skip
+* Returns
+*   uint8_t - width of the glyph in columns
+********************************************************/
+static uint8_t glyphWidth(const Uno_HUB75_Driver::Font& f, uint8_t& chr, uint8_t& lead)
+{
+  if (chr < f.first)        chr = f.first;
+  else if (chr > f.last)    chr = f.last;
+
+  chr -= f.first;
+  lead = 0;
+
+  if (f.spans)
+  {
+    uint8_t span = pgm_read_byte(&f.spans[chr]);
+
+    lead = span >> 4;
+    return (span & 0x0f);
+  }
+
+  return (f.cols);
+}
+
+/********************************************************
+* drawGlyph()
+*********************************************************
+* Draw one character of a font.  The top row of the glyph
+* goes at Y, and each row after that one pixel lower in Y
+* (up the panel, with the origin at the bottom left like
+* the examples use).  That's how drawChar() has always
+* drawn.
+*
+* The glyph is clipped to the panel first, to the columns
+* and a mask of the rows that are on it.  Then each column
+* is read from FLASH and its pixels stored directly
+*
+* Parameters:
+*   const Uno_HUB75_Driver::Font& f - the font, in RAM
+*   int16_t x - X coordinate of the left column
+*   int16_t y - Y coordinate of the top row
+*   uint8_t chr - the character
+*   Uno_HUB75_Driver::Pixel c - the color, from toPixel()
+* Returns
+*   uint8_t - width of the glyph in columns
+********************************************************/
+uint8_t Uno_HUB75_Driver::drawGlyph(const Uno_HUB75_Driver::Font& f, int16_t x, int16_t y, uint8_t chr, Uno_HUB75_Driver::Pixel c)
+{
+  uint8_t lead;
+  uint8_t width = glyphWidth(f, chr, lead);
+
+  // all of it off the left edge.  Checked first, since -x and
+  // MAXX - x below don't fit in 16 bits for an X near -32768
+  if ((int32_t)x + width <= 0)
+  {
+    return (width);
+  }
+
+  // columns on the panel
+  int16_t col1 = (x < 0) ? -x : 0;
+  int16_t col2 = min((int16_t)(width - 1), (int16_t)(MAXX - x));
+
+  // glyph row 'r' is at y - r, so these are the rows on the panel
+  int16_t row1 = max((int16_t)0, (int16_t)(y - MAXY));
+  int16_t row2 = min((int16_t)(f.height - 1), y);
+
+  if (col1 > col2 || row1 > row2)
+  {
+    return (width);
+  }
+
+  uint16_t rowMask = (uint16_t)((2UL << row2) - 1) & ~(uint16_t)((1UL << row1) - 1);
+  uint8_t bytes = (f.height + 7) / 8;
+  const uint8_t* bits = f.bitmap + ((uint16_t)chr * f.cols + lead + col1) * bytes;
+
+  for (int16_t col = col1; col <= col2; ++col)
+  {
+    uint16_t column = pgm_read_byte(bits++);
+
+    if (bytes > 1)
+    {
+      column |= (uint16_t)pgm_read_byte(bits++) << 8;
+    }
+
+    column &= rowMask;
+
+    // one pixel per set bit, moving up from the top row
+    for (int16_t py = y; column; --py, column >>= 1)
+    {
+      if (column & 0x01)
+      {
+        if (xlatFunc)
+        {
+          this->setBuff(x + col, py, c);
+        }
+        else
+        {
+          this->putBuff(x + col, py, c);
+        }
+      }
+    }
+  }
+
+  return (width);
+}
+
+/********************************************************
+* textRun()
+*********************************************************
+* Draw or measure a string in the current font.  Once the
+* string is past the right edge of the panel, the rest is
+* only measured
+*
+* Parameters:
+*   int16_t x - X coordinate of the left edge
+*   int16_t y - Y coordinate of the top row
+*   const char* str - the string
+*   bool inFlash - true if the string is in PROGMEM
+*   Uno_HUB75_Driver::Colors c - the color
+*   bool draw - false to only measure
+* Returns
+*   int16_t - width of the text in pixels
+********************************************************/
+int16_t Uno_HUB75_Driver::textRun(int16_t x, int16_t y, const char* str, bool inFlash, Uno_HUB75_Driver::Colors c, bool draw)
+{
+  // the font is only a few bytes; get it out of FLASH once
+  Uno_HUB75_Driver::Font f;
+  memcpy_P(&f, font, sizeof(f));
+
+  Uno_HUB75_Driver::Pixel pix = toPixel(c);
+  int16_t left = x;
+  uint8_t chr;
+
+  for (bool first = true; (chr = inFlash ? pgm_read_byte(str) : *str) != 0; ++str, first = false)
+  {
+    // spacing between characters, not after the last one
+    if (!first)
+    {
+      x += f.spacing;
+    }
+
+    if (draw && x <= MAXX)
+    {
+      x += this->drawGlyph(f, x, y, chr, pix);
+    }
+    else
+    {
+      uint8_t lead;
+      x += glyphWidth(f, chr, lead);
+    }
+  }
+
+  return (x - left);
+}
+
+/********************************************************
+* drawText()
+*********************************************************
+* Draw a string in the font picked by setFont().  See
+* drawGlyph() for which way is up
+*
+* Parameters:
+*   int16_t x - X coordinate of the left edge
+*   int16_t y - Y coordinate of the top row
+*   const char* str - the string
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   int16_t - width of the text in pixels
+********************************************************/
+int16_t Uno_HUB75_Driver::drawText(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c)
+{
+  return (this->textRun(x, y, str, false, c, true));
+}
+
+/********************************************************
+* drawText_P()
+*********************************************************
+* Same as drawText(), for a string in FLASH; PSTR("...")
+* or a PGM_P.  drawText() calls this for F("...")
+*
+* Parameters:
+*   int16_t x - X coordinate of the left edge
+*   int16_t y - Y coordinate of the top row
+*   PGM_P str - the string, in PROGMEM
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   int16_t - width of the text in pixels
+********************************************************/
+int16_t Uno_HUB75_Driver::drawText_P(int16_t x, int16_t y, PGM_P str, Uno_HUB75_Driver::Colors c)
+{
+  return (this->textRun(x, y, str, true, c, true));
+}
+
+/********************************************************
+* textWidth()
+*********************************************************
+* How wide a string would be in the current font, for
+* centering or right aligning it, or knowing when it has
+* scrolled off the panel.  There's no spacing after the
+* last character
+*
+* Parameters:
+*   const char* str - the string
+* Returns
+*   int16_t - width of the text in pixels
+********************************************************/
+int16_t Uno_HUB75_Driver::textWidth(const char* str)
+{
+  return (this->textRun(0, 0, str, false, Uno_HUB75_Driver::BLACK, false));
+}
+
+/********************************************************
+* textWidth_P()
+*********************************************************
+* Same as textWidth(), for a string in FLASH
+*
+* Parameters:
+*   PGM_P str - the string, in PROGMEM
+* Returns
+*   int16_t - width of the text in pixels
+********************************************************/
+int16_t Uno_HUB75_Driver::textWidth_P(PGM_P str)
+{
+  return (this->textRun(0, 0, str, true, Uno_HUB75_Driver::BLACK, false));
+}
+
+/********************************************************
+* drawChar()
+*********************************************************
+* Draw and ascii character on the panel at the specified
+* coordinates using specified color
+*
+* This method will draw 5x7 pixel bitmapped font
+* characters on the panel, no matter what setFont() was
+* given.  The top of the character is at Y, and it's
+* drawn toward lower Y (see drawGlyph())
+*
+* The font characters are stored in flash memory to save
+* RAM; otherwise it would consume another 640 bytes - more
+* than both framebuffers!  They are read straight from
+* there a column at a time.
+*
+* Paramters:
+*   int16_t x - the X coordinate
+*   int16_t y - the Y coordinate
+*   char chr - character to print
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::drawChar(int16_t x, int16_t y, char chr, Uno_HUB75_Driver::Colors c)
+{
+  Uno_HUB75_Driver::Font f;
+  memcpy_P(&f, &hub75Font5x7, sizeof(f));
+
+  // cast to unsigned; anything over 0x7f is drawn as DEL
+  this->drawGlyph(f, x, y, (uint8_t)chr, toPixel(c));
+}
+
+/********************************************************
+* drawString()
+*********************************************************
+* Draw ascii characters on the panel at the specified
+* coordinates using specified color
+*
+* This method will draw 5x7 pixel bitmapped font
+* characters on the panel, 6 pixels apart.  Use
+* drawText() for the other fonts
+*
+* Paramters:
+*   int16_t x - the X coordinate
+*   int16_t y - the Y coordinate
+*   const char* str - string to print
+*   Uno_HUB75_Driver::Colors c - the color
+* Returns
+*   void
+********************************************************/
+void Uno_HUB75_Driver::drawString(int16_t x, int16_t y, const char* str, Uno_HUB75_Driver::Colors c)
+{
+  Uno_HUB75_Driver::Font f;
+  memcpy_P(&f, &hub75Font5x7, sizeof(f));
+
+  Uno_HUB75_Driver::Pixel pix = toPixel(c);
+
+  // stop at the right edge of the panel
+  for (; *str && x <= MAXX; ++str)
+  {
+    this->drawGlyph(f, x, y, (uint8_t)*str, pix);
+
+    // index 6 pixels right for the next char
+    x += 6;
+  }
+}
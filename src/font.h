@@ -178,4 +178,24 @@ const uint8_t font5x7[][5] PROGMEM = {{0x55, 0x2a, 0x55, 0x2a, 0x55}, // 0x00 NU
                         {0x10, 0x08, 0x08, 0x08, 0x04}, // 0x7d '~'
                         {0x7f, 0x7f, 0x7f, 0x7f, 0x7f}}; // 0x7f 'DEL'
        
+/**********************************************************
+ * Proportional spacing for font5x7.  One byte per
+ * character: the high nibble is how many blank columns to
+ * skip on the left of the glyph, the low nibble is how
+ * many columns wide it is after that.  Narrow characters
+ * like 'i', '1' and '.' take less room this way.  The
+ * control characters and DEL are left full width, and the
+ * space is 3 columns.
+**********************************************************/
+const uint8_t font5x7Spans[128] PROGMEM = {
+  0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,  // 0x00
+  0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,  // 0x10
+  0x03, 0x21, 0x13, 0x05, 0x05, 0x05, 0x05, 0x21, 0x22, 0x12, 0x05, 0x05, 0x12, 0x05, 0x12, 0x05,  // 0x20
+  0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x12, 0x12, 0x04, 0x05, 0x14, 0x05,  // 0x30
+  0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05,  // 0x40
+  0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x23, 0x05, 0x03, 0x05, 0x05,  // 0x50
+  0x12, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x13, 0x13, 0x04, 0x04, 0x05, 0x05, 0x05,  // 0x60
+  0x04, 0x04, 0x04, 0x05, 0x13, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x14, 0x21, 0x04, 0x05, 0x05  // 0x70
+};
+
 #endif // FONT_H_
\ No newline at end of file
@@ -0,0 +1,130 @@
+/**********************************************************
+ * @file    font3x5.h
+ * @author  M.Brugman (mattb@linux.com)
+ * @license MIT (see license.txt)
+ **********************************************************
+ * A 3x5 bitmap font, for two lines of text on a 16 row
+ * panel.  Laid out the same way as font5x7 (see font.h):
+ * one byte for each column, with bit zero the top pixel.
+ * 
+ * Only the printable characters, 0x20 (space) to 0x7e
+ * ('~'), are here.  There's no room for descenders, so
+ * 'g', 'p', 'q' and 'y' are squeezed into the 5 rows.
+ * It's 285 bytes of FLASH.
+ * 
+ * So, the mapping of character 0x34 (numeral '4') looks 
+ * like this:
+ * 
+ *      012 (BYTE) 
+ *    0 X X
+ *  B 1 X X
+ *  I 2 XXX
+ *  T 3   X
+ *    4   X
+ * 
+ *   BYTE 0: 0x07
+ *        1: 0x04
+ *        2: 0x1f
+**********************************************************/
+#ifndef FONT3X5_H_
+#define FONT3X5_H_
+
+const uint8_t font3x5[][3] PROGMEM = {
+  {0x00, 0x00, 0x00}, // 0x20 space
+  {0x00, 0x17, 0x00}, // 0x21 '!'
+  {0x03, 0x00, 0x03}, // 0x22 '"'
+  {0x1f, 0x0a, 0x1f}, // 0x23 '#'
+  {0x12, 0x1f, 0x09}, // 0x24 '$'
+  {0x09, 0x04, 0x12}, // 0x25 '%'
+  {0x0f, 0x17, 0x1c}, // 0x26 '&'
+  {0x00, 0x03, 0x00}, // 0x27 '\''
+  {0x00, 0x0e, 0x11}, // 0x28 '('
+  {0x11, 0x0e, 0x00}, // 0x29 ')'
+  {0x05, 0x02, 0x05}, // 0x2a '*'
+  {0x04, 0x0e, 0x04}, // 0x2b '+'
+  {0x10, 0x08, 0x00}, // 0x2c ','
+  {0x04, 0x04, 0x04}, // 0x2d '-'
+  {0x00, 0x10, 0x00}, // 0x2e '.'
+  {0x18, 0x04, 0x03}, // 0x2f '/'
+  {0x1f, 0x11, 0x1f}, // 0x30 '0'
+  {0x12, 0x1f, 0x10}, // 0x31 '1'
+  {0x19, 0x15, 0x12}, // 0x32 '2'
+  {0x11, 0x15, 0x0a}, // 0x33 '3'
+  {0x07, 0x04, 0x1f}, // 0x34 '4'
+  {0x17, 0x15, 0x09}, // 0x35 '5'
+  {0x1e, 0x15, 0x1d}, // 0x36 '6'
+  {0x01, 0x1d, 0x03}, // 0x37 '7'
+  {0x1f, 0x15, 0x1f}, // 0x38 '8'
+  {0x17, 0x15, 0x0f}, // 0x39 '9'
+  {0x00, 0x0a, 0x00}, // 0x3a ':'
+  {0x10, 0x0a, 0x00}, // 0x3b ';'
+  {0x04, 0x0a, 0x11}, // 0x3c '<'
+  {0x0a, 0x0a, 0x0a}, // 0x3d '='
+  {0x11, 0x0a, 0x04}, // 0x3e '>'
+  {0x01, 0x15, 0x03}, // 0x3f '?'
+  {0x0e, 0x15, 0x16}, // 0x40 '@'
+  {0x1e, 0x05, 0x1e}, // 0x41 'A'
+  {0x1f, 0x15, 0x0a}, // 0x42 'B'
+  {0x0e, 0x11, 0x11}, // 0x43 'C'
+  {0x1f, 0x11, 0x0e}, // 0x44 'D'
+  {0x1f, 0x15, 0x15}, // 0x45 'E'
+  {0x1f, 0x05, 0x05}, // 0x46 'F'
+  {0x0e, 0x11, 0x1d}, // 0x47 'G'
+  {0x1f, 0x04, 0x1f}, // 0x48 'H'
+  {0x11, 0x1f, 0x11}, // 0x49 'I'
+  {0x08, 0x10, 0x0f}, // 0x4a 'J'
+  {0x1f, 0x04, 0x1b}, // 0x4b 'K'
+  {0x1f, 0x10, 0x10}, // 0x4c 'L'
+  {0x1f, 0x06, 0x1f}, // 0x4d 'M'
+  {0x1f, 0x0e, 0x1f}, // 0x4e 'N'
+  {0x0e, 0x11, 0x0e}, // 0x4f 'O'
+  {0x1f, 0x05, 0x02}, // 0x50 'P'
+  {0x0e, 0x19, 0x1e}, // 0x51 'Q'
+  {0x1f, 0x05, 0x1a}, // 0x52 'R'
+  {0x12, 0x15, 0x09}, // 0x53 'S'
+  {0x01, 0x1f, 0x01}, // 0x54 'T'
+  {0x1f, 0x10, 0x1f}, // 0x55 'U'
+  {0x07, 0x18, 0x07}, // 0x56 'V'
+  {0x1f, 0x0c, 0x1f}, // 0x57 'W'
+  {0x1b, 0x04, 0x1b}, // 0x58 'X'
+  {0x03, 0x1c, 0x03}, // 0x59 'Y'
+  {0x19, 0x15, 0x13}, // 0x5a 'Z'
+  {0x1f, 0x11, 0x00}, // 0x5b '['
+  {0x03, 0x04, 0x18}, // 0x5c '\\'
+  {0x00, 0x11, 0x1f}, // 0x5d ']'
+  {0x02, 0x01, 0x02}, // 0x5e '^'
+  {0x10, 0x10, 0x10}, // 0x5f '_'
+  {0x01, 0x02, 0x00}, // 0x60 '`'
+  {0x1a, 0x16, 0x1c}, // 0x61 'a'
+  {0x1f, 0x12, 0x0c}, // 0x62 'b'
+  {0x0c, 0x12, 0x12}, // 0x63 'c'
+  {0x0c, 0x12, 0x1f}, // 0x64 'd'
+  {0x0c, 0x1a, 0x16}, // 0x65 'e'
+  {0x04, 0x1e, 0x05}, // 0x66 'f'
+  {0x14, 0x1a, 0x0e}, // 0x67 'g'
+  {0x1f, 0x02, 0x1c}, // 0x68 'h'
+  {0x00, 0x1d, 0x00}, // 0x69 'i'
+  {0x08, 0x10, 0x0d}, // 0x6a 'j'
+  {0x1f, 0x0c, 0x12}, // 0x6b 'k'
+  {0x11, 0x1f, 0x10}, // 0x6c 'l'
+  {0x1e, 0x0e, 0x1e}, // 0x6d 'm'
+  {0x1e, 0x02, 0x1c}, // 0x6e 'n'
+  {0x0c, 0x12, 0x0c}, // 0x6f 'o'
+  {0x1e, 0x0a, 0x04}, // 0x70 'p'
+  {0x04, 0x0a, 0x1e}, // 0x71 'q'
+  {0x1c, 0x02, 0x02}, // 0x72 'r'
+  {0x14, 0x1e, 0x0a}, // 0x73 's'
+  {0x02, 0x1f, 0x12}, // 0x74 't'
+  {0x0e, 0x10, 0x1e}, // 0x75 'u'
+  {0x06, 0x18, 0x06}, // 0x76 'v'
+  {0x1e, 0x1c, 0x1e}, // 0x77 'w'
+  {0x12, 0x0c, 0x12}, // 0x78 'x'
+  {0x16, 0x08, 0x06}, // 0x79 'y'
+  {0x1a, 0x1e, 0x16}, // 0x7a 'z'
+  {0x04, 0x1f, 0x11}, // 0x7b '{'
+  {0x00, 0x1f, 0x00}, // 0x7c '|'
+  {0x11, 0x1f, 0x04}, // 0x7d '}'
+  {0x04, 0x06, 0x02}  // 0x7e '~'
+};
+
+#endif // FONT3X5_H_